@@ -32,7 +32,7 @@ bool ScannerGameSeed::levelMatches(std::optional<uint32_t> levelSeed)
 		return false;
 
 	if (levelSeed == *Config.target) {
-		std::cout << sgGameInitInfo.dwSeed << std::endl;
+		report(levelSeed);
 		return true;
 	}
 
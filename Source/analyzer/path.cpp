@@ -1,11 +1,18 @@
 #include "path.h"
 
+#include <bit>
+#include <climits>
+#include <cstring>
 #include <iostream>
 
 #include "../../types.h"
 
 #include "puzzler.h"
 #include "../funkMapGen.h"
+#include "../lighting.h"
+#include "../mapGen/pathQuery.h"
+#include "../mapGen/results.h"
+#include "../mapGen/walkability.h"
 #include "../objects.h"
 #include "../path.h"
 #include "../quests.h"
@@ -15,6 +22,7 @@ namespace {
 #define MAXVIEWX 21
 #define MAXVIEWY 21
 
+/** The tiles on screen around the player, a teleport can only target these */
 bool isVisible[MAXVIEWY][MAXVIEWX] = {
 	{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 }, //	-y
 	{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0 },
@@ -41,60 +49,206 @@ bool isVisible[MAXVIEWY][MAXVIEWX] = {
 
 Point StairsDownPrevious;
 
-BOOL PosOkPlayer(int pnum, int x, int y)
+/** The doors are open and breakable objects do not block, built for the first path of a level */
+Walkability walkability;
+PathQuery pathQuery(walkability);
+
+/** The player's light radius, which is also how far the player sees */
+constexpr int PlayerVisionRadius = 10;
+
+/** isVisible as the rows of a DoVisionMask() mask */
+struct ScreenMask {
+	uint64_t rows[VISION_MASK_SIZE] = {};
+
+	ScreenMask()
+	{
+		for (int vertical = 0; vertical < MAXVIEWY; vertical++) {
+			for (int horizontal = 0; horizontal < MAXVIEWX; horizontal++) {
+				if (isVisible[vertical][horizontal])
+					rows[horizontal - MAXVIEWX / 2 + VISION_MASK_RADIUS] |= 1ULL << (vertical - MAXVIEWY / 2 + VISION_MASK_RADIUS);
+			}
+		}
+	}
+};
+
+const ScreenMask screen;
+
+/** One bit per tile, bit y % 64 of rows[x][y / 64] is the tile (x, y) */
+struct TileSet {
+	static constexpr int RowWords = (MAXDUNY + 63) / 64;
+
+	uint64_t rows[MAXDUNX][RowWords];
+
+	void Insert(int x, int y)
+	{
+		rows[x][y / 64] |= 1ULL << (y % 64);
+	}
+
+	void Erase(int x, int y)
+	{
+		rows[x][y / 64] &= ~(1ULL << (y % 64));
+	}
+
+	/**
+	 * @brief The tiles (x, minY) to (x, minY + 63) as bits, the ones outside the dungeon are not in the set
+	 */
+	uint64_t Window(int x, int minY) const
+	{
+		if (x < 0 || x >= MAXDUNX || minY <= -64 || minY >= MAXDUNY)
+			return 0;
+		if (minY < 0)
+			return rows[x][0] << -minY;
+
+		int word = minY / 64;
+		int shift = minY % 64;
+		uint64_t bits = rows[x][word] >> shift;
+		if (shift != 0 && word + 1 < RowWords)
+			bits |= rows[x][word + 1] << (64 - shift);
+		return bits;
+	}
+};
+
+/** Walkable tiles of the level, built with walkability */
+TileSet walkableTiles;
+/** Tiles a teleport can still land on, walkable ones that have not been reached yet */
+TileSet teleportOpen;
+
+/** A tile reached by a teleport */
+struct Landing {
+	Point tile;
+	/** How far from where the teleport was cast */
+	int distance;
+};
+
+/** Tiles to teleport from, in the order they were reached */
+Landing teleportQueue[MAXDUNX * MAXDUNY];
+
+/** The tiles a teleport cast from each tile can target, on screen and in view, kept for the level */
+uint64_t teleportTargets[MAXDUNX][MAXDUNY][VISION_MASK_SIZE];
+/** teleportTargets of a tile is valid when its stamp is teleportLevel */
+uint32_t teleportTargetsStamp[MAXDUNX][MAXDUNY];
+uint32_t teleportLevel;
+
+void UpdateWalkability()
 {
-	if (x < 0 || y < 0 || x >= MAXDUNX || y >= MAXDUNY)
-		return FALSE;
-	int tileId = dPiece[x][y];
-	if (tileId == 0)
-		return FALSE;
-	if (nSolidTable[tileId])
-		return FALSE;
-
-	if (dObject[x][y] != 0) {
-		ObjectStruct *obj = &object[abs(dObject[x][y]) - 1];
-		if (obj->_oSolidFlag && !obj->_oBreak) {
-			return FALSE;
+	if (walkability.IsValid())
+		return;
+
+	InitPathWalkability(walkability);
+	walkability.Select(Walkability::DoorsOpen, Walkability::BreakablesPass);
+
+	memset(&walkableTiles, 0, sizeof(walkableTiles));
+	for (int x = 0; x < MAXDUNX; x++) {
+		for (int y = 0; y < MAXDUNY; y++) {
+			if (walkability.IsWalkable(x, y))
+				walkableTiles.Insert(x, y);
 		}
 	}
+}
 
-	return TRUE;
+/**
+ * @brief Forget the walkability and teleport targets of the previous level
+ */
+void InvalidateLevel()
+{
+	walkability.Invalidate();
+	if (++teleportLevel == 0) {
+		memset(teleportTargetsStamp, 0, sizeof(teleportTargetsStamp));
+		teleportLevel = 1;
+	}
+}
+
+const uint64_t *TeleportTargets(Point from)
+{
+	uint64_t(&targets)[VISION_MASK_SIZE] = teleportTargets[from.x][from.y];
+	if (teleportTargetsStamp[from.x][from.y] == teleportLevel)
+		return targets;
+
+	DoVisionMask(from.x, from.y, PlayerVisionRadius, targets);
+	for (int i = 0; i < VISION_MASK_SIZE; i++)
+		targets[i] &= screen.rows[i];
+	teleportTargetsStamp[from.x][from.y] = teleportLevel;
+
+	return targets;
 }
 
 int PathLength(Point start, Point end)
 {
-	return FindPath(PosOkPlayer, 0, start.x, start.y, end.x, end.y, Path);
+	UpdateWalkability();
+	return pathQuery.Find(start, end, Path);
 }
 
 /**
- * Unused
+ * @brief Count the teleports from start to end, each landing on a walkable tile that is on screen and
+ * in view where it is cast
+ *
+ * The search goes breadth first over the number of casts. A tile is only cast from if a tile that
+ * has not been reached yet is on screen around it, and the tiles a cast reaches are kept for the level.
+ * The tiles reached farthest away are cast from first, as they tend to see the most new tiles and
+ * leave nothing to find for the ones behind them.
+ *
+ * @return The number of teleports, -1 if end can't be reached, maxHops + 1 if it takes more than maxHops
  */
-bool IsVisible(Point start, Point end)
+int TeleportHops(Point start, Point end, int maxHops)
 {
-	if (start == Point { -1, -1 } || end == Point { -1, -1 }) {
-		return false;
+	if (start == end)
+		return 0;
+
+	UpdateWalkability();
+	memcpy(&teleportOpen, &walkableTiles, sizeof(teleportOpen));
+	teleportOpen.Erase(start.x, start.y);
+	teleportOpen.Insert(end.x, end.y);
+	teleportQueue[0] = { start, 0 };
+	int head = 0;
+	int tail = 1;
+
+	for (int hops = 1; head != tail; hops++) {
+		if (hops > maxHops)
+			return maxHops + 1;
+
+		int castsEnd = tail;
+		for (int distance = MAXVIEWX / 2; distance >= 0; distance--) {
+			for (int cast = head; cast < castsEnd; cast++) {
+				if (teleportQueue[cast].distance != distance)
+					continue;
+
+				Point from = teleportQueue[cast].tile;
+				int minX = from.x - VISION_MASK_RADIUS;
+				int minY = from.y - VISION_MASK_RADIUS;
+
+				uint64_t open[VISION_MASK_SIZE];
+				uint64_t anyOpen = 0;
+				for (int i = 0; i < VISION_MASK_SIZE; i++) {
+					open[i] = screen.rows[i] & teleportOpen.Window(minX + i, minY);
+					anyOpen |= open[i];
+				}
+				if (anyOpen == 0)
+					continue;
+
+				const uint64_t *targets = TeleportTargets(from);
+				for (int i = 0; i < VISION_MASK_SIZE; i++) {
+					int x = minX + i;
+					for (uint64_t row = targets[i] & open[i]; row != 0; row &= row - 1) {
+						int y = minY + std::countr_zero(row);
+						if (x == end.x && y == end.y)
+							return hops;
+						teleportOpen.Erase(x, y);
+						teleportQueue[tail++] = { { x, y }, std::max(std::abs(x - from.x), std::abs(y - from.y)) };
+					}
+				}
+			}
+		}
+		head = castsEnd;
 	}
 
-	int horizontal = end.x - start.x + 10;
-	int vertical = end.y - start.y + 10;
-
-	if (horizontal < 0 || horizontal > MAXVIEWX)
-		return false;
-	if (vertical < 0 || vertical > MAXVIEWY)
-		return false;
-	return isVisible[vertical][horizontal];
+	return -1;
 }
 
 int TotalTickLenth;
 
 std::string formatTime()
 {
-	float time = (float)TotalTickLenth / 20;
-	int min = time / 60;
-	char fmt[12];
-	sprintf(fmt, "%u:%05.2lf", min, time - min * 60);
-
-	return fmt;
+	return FormatTicks(TotalTickLenth);
 }
 
 int CalcStairsChebyshevDistance(Point start, Point end)
@@ -123,26 +277,40 @@ int GetWalkTime(Point start, Point end)
 	return stairsPath * ticksToWalkATile;
 }
 
-int GetTeleportTime(Point start, Point end)
+/**
+ * @brief Ticks left before the run is over the target
+ */
+int RemainingTicks(int tickLenth)
+{
+	if (!Config.target)
+		return INT_MAX;
+
+	return (int)*Config.target * 20 - TotalTickLenth - tickLenth;
+}
+
+/**
+ * @return The ticks it takes to teleport from start to end, -1 if end can't be reached, more than
+ * maxTicks if the search was given up on
+ */
+int GetTeleportTime(Point start, Point end, int maxTicks = INT_MAX)
 {
 	constexpr int ticksToTeleport = 12;
 
-	int cDistance = CalcStairsChebyshevDistance(start, end);
-	if (cDistance == -1) {
+	if (start == Point { -1, -1 } || end == Point { -1, -1 })
 		return -1;
-	}
 
-	if (IsVisible(start, end))
-		cDistance = 5;
+	int maxHops = std::max(maxTicks, 0) / ticksToTeleport;
+	int hops = TeleportHops(start, end, maxHops);
+	if (hops == -1)
+		return -1;
 
-	/** @todo Take teleport limits in to considerations instead of just estimating 5 steps */
-	return cDistance * ticksToTeleport / 5;
+	return hops * ticksToTeleport;
 }
 
-int GetShortestTeleportTime(Point startA, Point startB, Point end)
+int GetShortestTeleportTime(Point startA, Point startB, Point end, int maxTicks)
 {
-	int teleportTime = GetTeleportTime(startA, end);
-	int teleportTimePrevious = GetTeleportTime(startB, end);
+	int teleportTime = GetTeleportTime(startA, end, maxTicks);
+	int teleportTimePrevious = GetTeleportTime(startB, end, maxTicks);
 	if (teleportTime == -1)
 		teleportTime = teleportTimePrevious;
 	if (teleportTime == -1)
@@ -151,26 +319,6 @@ int GetShortestTeleportTime(Point startA, Point startB, Point end)
 	return std::min(teleportTime, teleportTimePrevious);
 }
 
-void setDoorSolidState(BOOLEAN doorState)
-{
-	if (leveltype == DTYPE_CATHEDRAL) {
-		nSolidTable[44] = doorState;
-		nSolidTable[46] = doorState;
-		nSolidTable[51] = doorState;
-		nSolidTable[56] = doorState;
-		nSolidTable[214] = doorState;
-		nSolidTable[270] = doorState;
-	} else if (leveltype == DTYPE_CATACOMBS) {
-		nSolidTable[55] = doorState;
-		nSolidTable[58] = doorState;
-		nSolidTable[538] = doorState;
-		nSolidTable[540] = doorState;
-	} else if (leveltype == DTYPE_CAVES) {
-		nSolidTable[531] = doorState;
-		nSolidTable[534] = doorState;
-	}
-}
-
 bool IsGoodLevelSoursororStrategy()
 {
 	int tickLenth = 0;
@@ -190,7 +338,7 @@ bool IsGoodLevelSoursororStrategy()
 		if (POI != Point { -1, -1 }) {
 			int walkTicks = GetWalkTime(Spawn, POI);
 			if (walkTicks != -1) {
-				int teleportTime = GetTeleportTime(Spawn, StairsDown);
+				int teleportTime = GetTeleportTime(Spawn, StairsDown, RemainingTicks(tickLenth + walkTicks + 40));
 				if (teleportTime != -1) {
 					pathToPuzzler += walkTicks;
 					pathToPuzzler += 40; // Pick up Puzzler
@@ -207,7 +355,7 @@ bool IsGoodLevelSoursororStrategy()
 			if (Config.verbose)
 				std::cerr << "Path: Went to town to get a book of teleport" << std::endl;
 			tickLenth += 880; // Buying a book of teleport
-			int walkTicks = GetTeleportTime(Spawn, StairsDown);
+			int walkTicks = GetTeleportTime(Spawn, StairsDown, RemainingTicks(tickLenth));
 			if (walkTicks == -1) {
 				if (Config.verbose)
 					std::cerr << "Path: Couldn't find the stairs" << std::endl;
@@ -236,7 +384,7 @@ bool IsGoodLevelSoursororStrategy()
 			target = POI;
 		}
 
-		int teleportTime = GetShortestTeleportTime(Spawn, StairsDownPrevious, target);
+		int teleportTime = GetShortestTeleportTime(Spawn, StairsDownPrevious, target, RemainingTicks(tickLenth));
 		if (teleportTime == -1) {
 			if (Config.verbose)
 				std::cerr << "Path: Couldn't find the stairs" << std::endl;
@@ -253,7 +401,7 @@ bool IsGoodLevelSoursororStrategy()
 
 		tickLenth += 460; // Defeat Lazarus
 
-		int teleportTime2 = GetTeleportTime(target, StairsDown);
+		int teleportTime2 = GetTeleportTime(target, StairsDown, RemainingTicks(tickLenth));
 		if (teleportTime2 == -1) {
 			if (Config.verbose)
 				std::cerr << "Path: Couldn't find the stairs" << std::endl;
@@ -261,7 +409,7 @@ bool IsGoodLevelSoursororStrategy()
 		}
 		tickLenth += teleportTime2;
 	} else {
-		int teleportTime = GetShortestTeleportTime(Spawn, StairsDownPrevious, StairsDown);
+		int teleportTime = GetShortestTeleportTime(Spawn, StairsDownPrevious, StairsDown, RemainingTicks(tickLenth));
 		if (teleportTime == -1) {
 			if (Config.verbose)
 				std::cerr << "Path: Couldn't find the stairs" << std::endl;
@@ -275,6 +423,7 @@ bool IsGoodLevelSoursororStrategy()
 	}
 
 	TotalTickLenth += tickLenth;
+	Scanner::recordAttribute(Attribute::PathTicks, TotalTickLenth);
 
 	if (Config.verbose)
 		std::cerr << "Path: Compleated dlvl " << (int)currlevel << " @ " << formatTime() << std::endl;
@@ -290,11 +439,8 @@ bool IsGoodLevelSoursororStrategy()
 
 bool IsGoodLevel()
 {
-	setDoorSolidState(FALSE); // Open doors
-	bool result = IsGoodLevelSoursororStrategy();
-	setDoorSolidState(TRUE); // Close doors
-
-	return result;
+	InvalidateLevel();
+	return IsGoodLevelSoursororStrategy();
 }
 
 bool Ended;
@@ -327,7 +473,7 @@ bool ScannerPath::skipLevel(int level)
 
 bool ScannerPath::levelMatches(std::optional<uint32_t> levelSeed)
 {
-	std::memset(Path, 0, sizeof(Path));
+	Path[0] = 0;
 	if (!IsGoodLevel()) {
 		Ended = true;
 		return Config.verbose;
@@ -337,7 +483,7 @@ bool ScannerPath::levelMatches(std::optional<uint32_t> levelSeed)
 
 	int level = currlevel;
 	if (level == 16) {
-		std::cout << sgGameInitInfo.dwSeed << " (etc " << formatTime() << ")" << std::endl;
+		report(std::nullopt, TotalTickLenth);
 		Ended = true;
 	}
 
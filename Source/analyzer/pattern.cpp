@@ -397,7 +397,7 @@ bool matchesSolidPattern()
 		}
 	}
 
-	std::cout << sgGameInitInfo.dwSeed << " possible game Seed for dlvl " << (int)currlevel << std::endl;
+	Scanner::report();
 
 	return true;
 }
@@ -448,7 +448,7 @@ bool matchesObjectPattern()
 			return false;
 	}
 
-	std::cout << sgGameInitInfo.dwSeed << " possible game Seed for dlvl " << (int)currlevel << std::endl;
+	Scanner::report();
 
 	return true;
 }
@@ -550,7 +550,7 @@ bool matchesTilePattern(std::optional<uint32_t> levelSeed)
 			return false;
 	}
 
-	std::cout << "Level Seed for dlvl " << (int)currlevel << ": " << *levelSeed << std::endl;
+	Scanner::report(levelSeed);
 
 	return true;
 }
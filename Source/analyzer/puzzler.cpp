@@ -137,6 +137,9 @@ void LocatePuzzler()
 			break;
 		}
 	}
+
+	Scanner::recordAttribute(Attribute::PuzzlerX, POI.x);
+	Scanner::recordAttribute(Attribute::PuzzlerY, POI.y);
 }
 
 bool ScannerPuzzler::levelMatches(std::optional<uint32_t> levelSeed)
@@ -170,7 +173,7 @@ bool ScannerPuzzler::levelMatches(std::optional<uint32_t> levelSeed)
 		}
 	}
 
-	std::cout << sgGameInitInfo.dwSeed << std::endl;
+	report();
 
 	return true;
 }
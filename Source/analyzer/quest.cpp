@@ -20,7 +20,7 @@ bool ScannerQuest::skipSeed()
 		return true;
 	}
 
-	std::cout << sgGameInitInfo.dwSeed << std::endl;
+	report();
 
 	return true;
 }
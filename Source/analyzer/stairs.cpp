@@ -5,6 +5,8 @@
 #include "../../types.h"
 
 #include "../funkMapGen.h"
+#include "../mapGen/pathQuery.h"
+#include "../mapGen/walkability.h"
 #include "../objects.h"
 #include "../path.h"
 #include "../quests.h"
@@ -22,34 +24,18 @@ int CalcStairsChebyshevDistance(Point start, Point end)
 	return std::max(horizontal, vertical);
 }
 
-BOOL PosOkPlayer(int pnum, int x, int y)
-{
-	if (x < 0 || y < 0 || x >= MAXDUNX || y >= MAXDUNY)
-		return FALSE;
-	int tileId = dPiece[x][y];
-	if (tileId == 0)
-		return FALSE;
-	if (nSolidTable[tileId])
-		return FALSE;
-
-	if (dObject[x][y] != 0) {
-		char bv;
-		if (dObject[x][y] > 0) {
-			bv = dObject[x][y] - 1;
-		} else {
-			bv = -(dObject[x][y] + 1);
-		}
-		if (object[bv]._oSolidFlag) {
-			return FALSE;
-		}
-	}
-
-	return TRUE;
-}
+/** The doors are closed and all solid objects block, built for the first path of a level */
+Walkability walkability;
+PathQuery pathQuery(walkability);
 
 int PathLength(Point start, Point end)
 {
-	return FindPath(PosOkPlayer, 0, start.x, start.y, end.x, end.y, Path);
+	if (!walkability.IsValid()) {
+		InitPathWalkability(walkability);
+		walkability.Select(Walkability::DoorsClosed, Walkability::BreakablesBlock);
+	}
+
+	return pathQuery.Find(start, end, Path);
 }
 
 int GetDistance(Point start, Point end, int maxDistance)
@@ -94,7 +80,8 @@ bool ScannerStairs::levelMatches(std::optional<uint32_t> levelSeed)
 	else if (leveltype == DTYPE_CATACOMBS)
 		maxDistance = 5;
 
-	std::memset(Path, 0, sizeof(Path));
+	walkability.Invalidate();
+	Path[0] = 0;
 	int steps = GetDistance(Spawn, StairsDown, maxDistance);
 	if (steps == -1) {
 		if (Config.verbose)
@@ -102,9 +89,20 @@ bool ScannerStairs::levelMatches(std::optional<uint32_t> levelSeed)
 		Failed = true;
 		return false;
 	}
+	Scanner::recordAttribute(Attribute::StairsDistance, steps);
 
 	if (currlevel >= 6)
-		std::cout << sgGameInitInfo.dwSeed << std::endl;
+		report();
 
 	return true;
 }
+
+uint32_t ScannerStairs::independentLevels()
+{
+	// Matches are only reported from dlvl 6, before that levels just have to pass
+	uint32_t levels = 0;
+	for (int level = 1; level < 6; level++)
+		levels |= 1U << level;
+
+	return levels;
+}
@@ -8,4 +8,5 @@ public:
 	bool skipSeed() override;
 	bool skipLevel(int level) override;
 	bool levelMatches(std::optional<uint32_t> levelSeed) override;
+	uint32_t independentLevels() override;
 };
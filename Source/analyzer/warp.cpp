@@ -13,10 +13,16 @@ bool ScannerWarp::skipLevel(int level)
 
 bool ScannerWarp::levelMatches(std::optional<uint32_t> levelSeed)
 {
+	recordAttribute(Attribute::Warp, POI != Point { -1, -1 } ? 1 : 0);
 	if (POI == Point { -1, -1 })
 		return false;
 
-	std::cout << sgGameInitInfo.dwSeed << std::endl;
+	report();
 
 	return true;
 }
+
+bool ScannerWarp::usesLevelFeaturesOnly()
+{
+	return true;
+}
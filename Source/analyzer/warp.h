@@ -6,4 +6,5 @@ class ScannerWarp : public Scanner {
 public:
 	bool skipLevel(int level) override;
 	bool levelMatches(std::optional<uint32_t> levelSeed) override;
+	bool usesLevelFeaturesOnly() override;
 };
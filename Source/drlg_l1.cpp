@@ -5,6 +5,11 @@
  */
 #include "all.h"
 
+#include <array>
+
+#include "mapGen/miniSetIndex.h"
+#include "mapGen/tileRules.h"
+
 /** Represents a tile ID map of twice the size, repeating each tile of the original map in blocks of 4. */
 BYTE L5dungeon[80][80];
 BYTE L5dflags[DMAXX][DMAXY];
@@ -36,7 +41,7 @@ BOOL VR3;
 BYTE *L5pSetPiece;
 
 /** Contains shadows for 2x2 blocks of base tile IDs in the Cathedral. */
-const ShadowStruct SPATS[37] = {
+constexpr ShadowStruct SPATS[37] = {
 	// clang-format off
 	// strig, s1, s2, s3, nv1, nv2, nv3
 	{      7, 13,  0, 13, 144,   0, 142 },
@@ -79,6 +84,43 @@ const ShadowStruct SPATS[37] = {
 	// clang-format on
 };
 
+/** Range of the SPATS entries triggered by each base tile ID */
+struct ShadowRange {
+	BYTE first;
+	BYTE last;
+};
+
+static constexpr std::array<ShadowRange, 256> BuildShadowIndex()
+{
+	std::array<ShadowRange, 256> index {};
+
+	for (int i = 37 - 1; i >= 0; i--) {
+		ShadowRange &range = index[SPATS[i].strig];
+		if (range.last == 0)
+			range.last = i + 1;
+		range.first = i;
+	}
+
+	return index;
+}
+
+static constexpr std::array<ShadowRange, 256> ShadowIndex = BuildShadowIndex();
+
+static constexpr bool ShadowIndexIsContiguous()
+{
+	for (int i = 0; i < 37; i++) {
+		const ShadowRange &range = ShadowIndex[SPATS[i].strig];
+		for (int j = range.first; j < range.last; j++) {
+			if (SPATS[j].strig != SPATS[i].strig)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+static_assert(ShadowIndexIsContiguous(), "The SPATS entries of a base tile must be next to each other");
+
 // BUGFIX: This array should contain an additional 0 (207 elements).
 /** Maps tile IDs to their corresponding base tile ID. */
 const BYTE BSTYPES[207] = {
@@ -506,6 +548,7 @@ BYTE L5ConvTbl[16] = { 22, 13, 1, 13, 2, 13, 13, 13, 4, 13, 1, 13, 2, 13, 16, 13
 #ifdef HELLFIRE
 void DRLG_InitL5Vals()
 {
+#ifndef GENERATION_ONLY
 	int i, j, pc;
 
 	for (j = 0; j < MAXDUNY; j++) {
@@ -520,6 +563,7 @@ void DRLG_InitL5Vals()
 			dSpecial[i][j] = pc;
 		}
 	}
+#endif
 }
 #endif
 
@@ -589,284 +633,284 @@ void drlg_l1_crypt_lavafloor()
 
 	for (j = 1; j < 40; j++) {
 		for (i = 1; i < 40; i++) {
-			switch (GetDungeon(i, j)) {
+			switch (dungeon[i][j]) {
 			case 5:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 7:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 8:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 9:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 10:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 11:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 12:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 14:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 15:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 17:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 95:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 96:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 208);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 208;
 				break;
 			case 116:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 118:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 119:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 120:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 121:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 122:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 211);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 212);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 211;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 212;
 				break;
 			case 123:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 125:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 126:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 128:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 133:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 135:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 136:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 137:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 213);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 214);
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 213;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 214;
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 138:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 139:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 215);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 216);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 215;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 216;
 				break;
 			case 140:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 217);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 217;
 				break;
 			case 142:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 143:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 213);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 214);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 213;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 214;
 				break;
 			case 145:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 213);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 214);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 213;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 214;
 				break;
 			case 150:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 217);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 217;
 				break;
 			case 152:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 153:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 154:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 155:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 205);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 205;
 				break;
 			case 156:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 157:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 217);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 217;
 				break;
 			case 159:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 160:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 206);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 207);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 206;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 207;
 				break;
 			case 162:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 209);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 210);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 209;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 210;
 				break;
 			case 167:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 209);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 210);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 209;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 210;
 				break;
 			case 187:
-				if (GetDungeon(i, j - 1) == 13)
-					SetDungeon(i, j - 1, 208);
+				if (dungeon[i][j - 1] == 13)
+					dungeon[i][j - 1] = 208;
 				break;
 			case 185:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 186:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 203);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 204);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 203;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 204;
 				break;
 			case 192:
-				if (GetDungeon(i - 1, j) == 13)
-					SetDungeon(i - 1, j, 209);
-				if (GetDungeon(i - 1, j - 1) == 13)
-					SetDungeon(i - 1, j - 1, 210);
+				if (dungeon[i - 1][j] == 13)
+					dungeon[i - 1][j] = 209;
+				if (dungeon[i - 1][j - 1] == 13)
+					dungeon[i - 1][j - 1] = 210;
 				break;
 			}
 		}
@@ -883,28 +927,26 @@ static void DRLG_L1Shadows()
 
 	for (y = 1; y < DMAXY; y++) {
 		for (x = 1; x < DMAXX; x++) {
-			sd[0][0] = BSTYPES[GetDungeon(x, y)];
-			sd[1][0] = BSTYPES[GetDungeon(x - 1, y)];
-			sd[0][1] = BSTYPES[GetDungeon(x, y - 1)];
-			sd[1][1] = BSTYPES[GetDungeon(x - 1, y - 1)];
-
-			for (i = 0; i < 37; i++) {
-				if (SPATS[i].strig == sd[0][0]) {
-					patflag = TRUE;
-					if (SPATS[i].s1 && SPATS[i].s1 != sd[1][1])
-						patflag = FALSE;
-					if (SPATS[i].s2 && SPATS[i].s2 != sd[0][1])
-						patflag = FALSE;
-					if (SPATS[i].s3 && SPATS[i].s3 != sd[1][0])
-						patflag = FALSE;
-					if (patflag == TRUE) {
-						if (SPATS[i].nv1 && !L5dflags[x - 1][y - 1])
-							SetDungeon(x - 1, y - 1, SPATS[i].nv1);
-						if (SPATS[i].nv2 && !L5dflags[x][y - 1])
-							SetDungeon(x, y - 1, SPATS[i].nv2);
-						if (SPATS[i].nv3 && !L5dflags[x - 1][y])
-							SetDungeon(x - 1, y, SPATS[i].nv3);
-					}
+			sd[0][0] = BSTYPES[dungeon[x][y]];
+			sd[1][0] = BSTYPES[dungeon[x - 1][y]];
+			sd[0][1] = BSTYPES[dungeon[x][y - 1]];
+			sd[1][1] = BSTYPES[dungeon[x - 1][y - 1]];
+
+			for (i = ShadowIndex[sd[0][0]].first; i < ShadowIndex[sd[0][0]].last; i++) {
+				patflag = TRUE;
+				if (SPATS[i].s1 && SPATS[i].s1 != sd[1][1])
+					patflag = FALSE;
+				if (SPATS[i].s2 && SPATS[i].s2 != sd[0][1])
+					patflag = FALSE;
+				if (SPATS[i].s3 && SPATS[i].s3 != sd[1][0])
+					patflag = FALSE;
+				if (patflag == TRUE) {
+					if (SPATS[i].nv1 && !L5dflags[x - 1][y - 1])
+						dungeon[x - 1][y - 1] = SPATS[i].nv1;
+					if (SPATS[i].nv2 && !L5dflags[x][y - 1])
+						dungeon[x][y - 1] = SPATS[i].nv2;
+					if (SPATS[i].nv3 && !L5dflags[x - 1][y])
+						dungeon[x - 1][y] = SPATS[i].nv3;
 				}
 			}
 		}
@@ -912,53 +954,53 @@ static void DRLG_L1Shadows()
 
 	for (y = 1; y < DMAXY; y++) {
 		for (x = 1; x < DMAXX; x++) {
-			if (GetDungeon(x - 1, y) == 139 && !L5dflags[x - 1][y]) {
+			if (dungeon[x - 1][y] == 139 && !L5dflags[x - 1][y]) {
 				tnv3 = 139;
-				if (GetDungeon(x, y) == 29)
+				if (dungeon[x][y] == 29)
 					tnv3 = 141;
-				if (GetDungeon(x, y) == 32)
+				if (dungeon[x][y] == 32)
 					tnv3 = 141;
-				if (GetDungeon(x, y) == 35)
+				if (dungeon[x][y] == 35)
 					tnv3 = 141;
-				if (GetDungeon(x, y) == 37)
+				if (dungeon[x][y] == 37)
 					tnv3 = 141;
-				if (GetDungeon(x, y) == 38)
+				if (dungeon[x][y] == 38)
 					tnv3 = 141;
-				if (GetDungeon(x, y) == 39)
+				if (dungeon[x][y] == 39)
 					tnv3 = 141;
-				SetDungeon(x - 1, y, tnv3);
+				dungeon[x - 1][y] = tnv3;
 			}
-			if (GetDungeon(x - 1, y) == 149 && !L5dflags[x - 1][y]) {
+			if (dungeon[x - 1][y] == 149 && !L5dflags[x - 1][y]) {
 				tnv3 = 149;
-				if (GetDungeon(x, y) == 29)
+				if (dungeon[x][y] == 29)
 					tnv3 = 153;
-				if (GetDungeon(x, y) == 32)
+				if (dungeon[x][y] == 32)
 					tnv3 = 153;
-				if (GetDungeon(x, y) == 35)
+				if (dungeon[x][y] == 35)
 					tnv3 = 153;
-				if (GetDungeon(x, y) == 37)
+				if (dungeon[x][y] == 37)
 					tnv3 = 153;
-				if (GetDungeon(x, y) == 38)
+				if (dungeon[x][y] == 38)
 					tnv3 = 153;
-				if (GetDungeon(x, y) == 39)
+				if (dungeon[x][y] == 39)
 					tnv3 = 153;
-				SetDungeon(x - 1, y, tnv3);
+				dungeon[x - 1][y] = tnv3;
 			}
-			if (GetDungeon(x - 1, y) == 148 && !L5dflags[x - 1][y]) {
+			if (dungeon[x - 1][y] == 148 && !L5dflags[x - 1][y]) {
 				tnv3 = 148;
-				if (GetDungeon(x, y) == 29)
+				if (dungeon[x][y] == 29)
 					tnv3 = 154;
-				if (GetDungeon(x, y) == 32)
+				if (dungeon[x][y] == 32)
 					tnv3 = 154;
-				if (GetDungeon(x, y) == 35)
+				if (dungeon[x][y] == 35)
 					tnv3 = 154;
-				if (GetDungeon(x, y) == 37)
+				if (dungeon[x][y] == 37)
 					tnv3 = 154;
-				if (GetDungeon(x, y) == 38)
+				if (dungeon[x][y] == 38)
 					tnv3 = 154;
-				if (GetDungeon(x, y) == 39)
+				if (dungeon[x][y] == 39)
 					tnv3 = 154;
-				SetDungeon(x - 1, y, tnv3);
+				dungeon[x - 1][y] = tnv3;
 			}
 		}
 	}
@@ -966,8 +1008,9 @@ static void DRLG_L1Shadows()
 
 static int DRLG_PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx, int cy, BOOL setview, int noquad, int ldir)
 {
-	int sx, sy, sw, sh, xx, yy, i, ii, numt, found, t;
+	int sx, sy, sw, sh, xx, yy, i, ii, numt, found, t, skip;
 	BOOL abort;
+	MiniSetIndex index;
 
 	sw = miniset[0];
 	sh = miniset[1];
@@ -977,6 +1020,26 @@ static int DRLG_PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx, in
 	else
 		numt = random_(0, tmax - tmin) + tmin;
 
+	index.Build(miniset, dungeon, L5dflags);
+	if (cx != -1)
+		index.Stop(cx - sw, 0, cx + 12, DMAXY);
+	if (cy != -1)
+		index.Stop(0, cy - sh, DMAXX, cy + 12);
+	switch (noquad) {
+	case 0:
+		index.Exclude(0, 0, cx - 1, cy - 1);
+		break;
+	case 1:
+		index.Exclude(cx + 1, 0, DMAXX, cy - 1);
+		break;
+	case 2:
+		index.Exclude(0, cy + 1, cx - 1, DMAXY);
+		break;
+	case 3:
+		index.Exclude(cx + 1, cy + 1, DMAXX, DMAXY);
+		break;
+	}
+
 	for (i = 0; i < numt; i++) {
 		sx = random_(0, DMAXX - sw);
 		sy = random_(0, DMAXY - sh);
@@ -984,6 +1047,13 @@ static int DRLG_PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx, in
 		found = 0;
 
 		while (abort == FALSE) {
+			// Jump over the positions that would only be stepped over
+			skip = index.Distance(sx, sy, 4001 - found);
+			found += skip;
+			if (found > 4000)
+				return -1;
+			index.Advance(sx, sy, skip);
+
 			abort = TRUE;
 			// BUGFIX: This code has no purpose but causes the set piece to never appear in x 0-13 or y 0-13
 			if (cx != -1 && sx >= cx - sw && sx <= cx + 12) {
@@ -1014,15 +1084,19 @@ static int DRLG_PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx, in
 				break;
 			}
 
-			ii = 2;
-
-			for (yy = 0; yy < sh && abort == TRUE; yy++) {
-				for (xx = 0; xx < sw && abort == TRUE; xx++) {
-					if (miniset[ii] && GetDungeon(xx + sx, sy + yy) != miniset[ii])
-						abort = FALSE;
-					if (L5dflags[xx + sx][sy + yy])
-						abort = FALSE;
-					ii++;
+			if (abort == TRUE && index.Contains(sx, sy)) {
+				abort = index.Matches(sx, sy) ? TRUE : FALSE;
+			} else {
+				ii = 2;
+
+				for (yy = 0; yy < sh && abort == TRUE; yy++) {
+					for (xx = 0; xx < sw && abort == TRUE; xx++) {
+						if (miniset[ii] && GetDungeon(xx + sx, sy + yy) != miniset[ii])
+							abort = FALSE;
+						if (L5dflags[xx + sx][sy + yy])
+							abort = FALSE;
+						ii++;
+					}
 				}
 			}
 
@@ -1046,6 +1120,7 @@ static int DRLG_PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx, in
 				ii++;
 			}
 		}
+		index.Update(sx, sy);
 	}
 
 	if (miniset == PWATERIN) {
@@ -1085,13 +1160,13 @@ static void DRLG_L1Floor()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (L5dflags[i][j] == 0 && GetDungeon(i, j) == 13) {
+			if (L5dflags[i][j] == 0 && dungeon[i][j] == 13) {
 				rv = random_(0, 3);
 
 				if (rv == 1)
-					SetDungeon(i, j, 162);
+					dungeon[i][j] = 162;
 				if (rv == 2)
-					SetDungeon(i, j, 163);
+					dungeon[i][j] = 163;
 			}
 		}
 	}
@@ -1099,103 +1174,22 @@ static void DRLG_L1Floor()
 
 static void DRLG_L1Pass3()
 {
-	int i, j, xx, yy;
-	long v1, v2, v3, v4, lv;
-
-	lv = 22 - 1;
-
-#ifdef USE_ASM
-	__asm {
-		mov		esi, pMegaTiles
-		mov		eax, lv
-		shl		eax, 3
-		add		esi, eax
-		xor		eax, eax
-		lodsw
-		inc		eax
-		mov		v1, eax
-		lodsw
-		inc		eax
-		mov		v2, eax
-		lodsw
-		inc		eax
-		mov		v3, eax
-		lodsw
-		inc		eax
-		mov		v4, eax
-	}
-#else
-	v1 = *((WORD *)&pMegaTiles[lv * 8] + 0) + 1;
-	v2 = *((WORD *)&pMegaTiles[lv * 8] + 1) + 1;
-	v3 = *((WORD *)&pMegaTiles[lv * 8] + 2) + 1;
-	v4 = *((WORD *)&pMegaTiles[lv * 8] + 3) + 1;
-#endif
-
-	for (j = 0; j < MAXDUNY; j += 2)
-	{
-		for (i = 0; i < MAXDUNX; i += 2) {
-			dPiece[i][j] = v1;
-			dPiece[i + 1][j] = v2;
-			dPiece[i][j + 1] = v3;
-			dPiece[i + 1][j + 1] = v4;
-		}
-	}
-
-	yy = 16;
-	for (j = 0; j < DMAXY; j++) {
-		xx = 16;
-		for (i = 0; i < DMAXX; i++) {
-			lv = GetDungeon(i, j) - 1;
-			/// ASSERT: assert(lv >= 0);
-#ifdef USE_ASM
-			__asm {
-				mov		esi, pMegaTiles
-				mov		eax, lv
-				shl		eax, 3
-				add		esi, eax
-				xor		eax, eax
-				lodsw
-				inc		eax
-				mov		v1, eax
-				lodsw
-				inc		eax
-				mov		v2, eax
-				lodsw
-				inc		eax
-				mov		v3, eax
-				lodsw
-				inc		eax
-				mov		v4, eax
-			}
-#else
-			v1 = *((WORD *)&pMegaTiles[lv * 8] + 0) + 1;
-			v2 = *((WORD *)&pMegaTiles[lv * 8] + 1) + 1;
-			v3 = *((WORD *)&pMegaTiles[lv * 8] + 2) + 1;
-			v4 = *((WORD *)&pMegaTiles[lv * 8] + 3) + 1;
-#endif
-			dPiece[xx][yy] = v1;
-			dPiece[xx + 1][yy] = v2;
-			dPiece[xx][yy + 1] = v3;
-			dPiece[xx + 1][yy + 1] = v4;
-			xx += 2;
-		}
-		yy += 2;
-	}
+	DRLG_ExpandMegaTiles(22);
 }
 
 static void DRLG_LoadL1SP()
 {
 	L5setloadflag = FALSE;
 	if (QuestStatus(Q_BUTCHER)) {
-		L5pSetPiece = LoadFileInMem("Levels\\L1Data\\rnd6.DUN", NULL);
+		L5pSetPiece = LoadLevelFileInMem("Levels\\L1Data\\rnd6.DUN", NULL);
 		L5setloadflag = TRUE;
 	}
 	if (QuestStatus(Q_SKELKING) && gbMaxPlayers == 1) {
-		L5pSetPiece = LoadFileInMem("Levels\\L1Data\\SKngDO.DUN", NULL);
+		L5pSetPiece = LoadLevelFileInMem("Levels\\L1Data\\SKngDO.DUN", NULL);
 		L5setloadflag = TRUE;
 	}
 	if (QuestStatus(Q_LTBANNER)) {
-		L5pSetPiece = LoadFileInMem("Levels\\L1Data\\Banner2.DUN", NULL);
+		L5pSetPiece = LoadLevelFileInMem("Levels\\L1Data\\Banner2.DUN", NULL);
 		L5setloadflag = TRUE;
 	}
 }
@@ -1209,12 +1203,20 @@ void DRLG_Init_Globals()
 {
 	char c;
 
-	memset(dFlags, 0, sizeof(dFlags));
+	// Only clear what was written since the last call, a level generated without content leaves these untouched
+	if (dirtyGrids & DIRTY_FLAGS)
+		memset(dFlags, 0, sizeof(dFlags));
+	if (dirtyGrids & DIRTY_MONSTER)
+		memset(dMonster, 0, sizeof(dMonster));
+	if (dirtyGrids & DIRTY_OBJECT)
+		memset(dObject, 0, sizeof(dObject));
+	if (dirtyGrids & DIRTY_ITEM)
+		memset(dItem, 0, sizeof(dItem));
+	dirtyGrids = 0;
+#ifndef GENERATION_ONLY
+	// No players are placed while generating
 	memset(dPlayer, 0, sizeof(dPlayer));
-	memset(dMonster, 0, sizeof(dMonster));
 	memset(dDead, 0, sizeof(dDead));
-	memset(dObject, 0, sizeof(dObject));
-	memset(dItem, 0, sizeof(dItem));
 	memset(dMissile, 0, sizeof(dMissile));
 	if (!lightflag) {
 		if (light4flag)
@@ -1225,10 +1227,12 @@ void DRLG_Init_Globals()
 		c = 0;
 	}
 	memset(dLight, c, sizeof(dLight));
+#endif
 }
 
 static void DRLG_InitL1Vals()
 {
+#ifndef GENERATION_ONLY
 	int i, j, pc;
 
 	for (j = 0; j < MAXDUNY; j++) {
@@ -1267,6 +1271,7 @@ static void DRLG_InitL1Vals()
 			dSpecial[i][j] = pc;
 		}
 	}
+#endif
 }
 
 #ifndef SPAWN
@@ -1281,11 +1286,11 @@ void LoadL1Dungeon(const char *sFileName, int vx, int vy)
 	dmaxy = 96;
 
 	DRLG_InitTrans();
-	pLevelMap = LoadFileInMem(sFileName, NULL);
+	pLevelMap = LoadLevelFileInMem(sFileName, NULL);
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			SetDungeon(i, j, 22);
+			dungeon[i][j] = 22;
 			L5dflags[i][j] = 0;
 		}
 	}
@@ -1328,11 +1333,11 @@ void LoadPreL1Dungeon(const char *sFileName, int vx, int vy)
 	dmaxx = 96;
 	dmaxy = 96;
 
-	pLevelMap = LoadFileInMem(sFileName, NULL);
+	pLevelMap = LoadLevelFileInMem(sFileName, NULL);
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			SetDungeon(i, j, 22);
+			dungeon[i][j] = 22;
 			L5dflags[i][j] = 0;
 		}
 	}
@@ -1359,7 +1364,7 @@ void LoadPreL1Dungeon(const char *sFileName, int vx, int vy)
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			pdungeon[i][j] = GetDungeon(i, j);
+			pdungeon[i][j] = dungeon[i][j];
 		}
 	}
 
@@ -1373,7 +1378,7 @@ static void InitL5Dungeon()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			SetDungeon(i, j, 0);
+			dungeon[i][j] = 0;
 			L5dflags[i][j] = 0;
 		}
 	}
@@ -1570,7 +1575,7 @@ static int L5GetArea()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 1)
+			if (dungeon[i][j] == 1)
 				rv++;
 		}
 	}
@@ -1587,10 +1592,10 @@ static void L5makeDungeon()
 		for (i = 0; i < DMAXX; i++) {
 			j_2 = j << 1;
 			i_2 = i << 1;
-			L5dungeon[i_2][j_2] = GetDungeon(i, j);
-			L5dungeon[i_2][j_2 + 1] = GetDungeon(i, j);
-			L5dungeon[i_2 + 1][j_2] = GetDungeon(i, j);
-			L5dungeon[i_2 + 1][j_2 + 1] = GetDungeon(i, j);
+			L5dungeon[i_2][j_2] = dungeon[i][j];
+			L5dungeon[i_2][j_2 + 1] = dungeon[i][j];
+			L5dungeon[i_2 + 1][j_2] = dungeon[i][j];
+			L5dungeon[i_2 + 1][j_2 + 1] = dungeon[i][j];
 		}
 	}
 }
@@ -1601,7 +1606,7 @@ static void L5makeDmt()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			SetDungeon(i, j, 22);
+			dungeon[i][j] = 22;
 		}
 	}
 
@@ -1774,32 +1779,32 @@ static void L5AddWall()
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
 			if (!L5dflags[i][j]) {
-				if (GetDungeon(i, j) == 3 && random_(0, 100) < 100) {
+				if (dungeon[i][j] == 3 && random_(0, 100) < 100) {
 					x = L5HWallOk(i, j);
 					if (x != -1)
 						L5HorizWall(i, j, 2, x);
 				}
-				if (GetDungeon(i, j) == 3 && random_(0, 100) < 100) {
+				if (dungeon[i][j] == 3 && random_(0, 100) < 100) {
 					y = L5VWallOk(i, j);
 					if (y != -1)
 						L5VertWall(i, j, 1, y);
 				}
-				if (GetDungeon(i, j) == 6 && random_(0, 100) < 100) {
+				if (dungeon[i][j] == 6 && random_(0, 100) < 100) {
 					x = L5HWallOk(i, j);
 					if (x != -1)
 						L5HorizWall(i, j, 4, x);
 				}
-				if (GetDungeon(i, j) == 7 && random_(0, 100) < 100) {
+				if (dungeon[i][j] == 7 && random_(0, 100) < 100) {
 					y = L5VWallOk(i, j);
 					if (y != -1)
 						L5VertWall(i, j, 4, y);
 				}
-				if (GetDungeon(i, j) == 2 && random_(0, 100) < 100) {
+				if (dungeon[i][j] == 2 && random_(0, 100) < 100) {
 					x = L5HWallOk(i, j);
 					if (x != -1)
 						L5HorizWall(i, j, 2, x);
 				}
-				if (GetDungeon(i, j) == 1 && random_(0, 100) < 100) {
+				if (dungeon[i][j] == 1 && random_(0, 100) < 100) {
 					y = L5VWallOk(i, j);
 					if (y != -1)
 						L5VertWall(i, j, 1, y);
@@ -1884,115 +1889,71 @@ static void DRLG_L5GHall(int x1, int y1, int x2, int y2)
 	}
 }
 
+/* centre, { checked neighbours }, replaced neighbour, the positions are (dx, dy) from the centre */
+constexpr TileRule L5TileFixRules1[] = {
+	{ 2, { { 1, 0, 22 } }, { 1, 0, 23 } },
+	{ 13, { { 1, 0, 22 } }, { 1, 0, 18 } },
+	{ 13, { { 1, 0, 2 } }, { 1, 0, 7 } },
+	{ 6, { { 1, 0, 22 } }, { 1, 0, 24 } },
+	{ 1, { { 0, 1, 22 } }, { 0, 1, 24 } },
+	{ 13, { { 0, 1, 1 } }, { 0, 1, 6 } },
+	{ 13, { { 0, 1, 22 } }, { 0, 1, 19 } },
+};
+constexpr auto L5TileFix1 = CompileTileRules(L5TileFixRules1);
+
+constexpr TileRule L5TileFixRules2[] = {
+	{ 13, { { 1, 0, 19 } }, { 1, 0, 21 } },
+	{ 13, { { 1, 0, 22 } }, { 1, 0, 20 } },
+	{ 7, { { 1, 0, 22 } }, { 1, 0, 23 } },
+	{ 13, { { 1, 0, 24 } }, { 1, 0, 21 } },
+	{ 19, { { 1, 0, 22 } }, { 1, 0, 20 } },
+	{ 2, { { 1, 0, 19 } }, { 1, 0, 21 } },
+	{ 19, { { 1, 0, 1 } }, { 1, 0, 6 } },
+	{ 7, { { 1, 0, 19 } }, { 1, 0, 21 } },
+	{ 2, { { 1, 0, 1 } }, { 1, 0, 6 } },
+	{ 3, { { 1, 0, 22 } }, { 1, 0, 24 } },
+	{ 21, { { 1, 0, 1 } }, { 1, 0, 6 } },
+	{ 7, { { 1, 0, 1 } }, { 1, 0, 6 } },
+	{ 7, { { 1, 0, 24 } }, { 1, 0, 21 } },
+	{ 4, { { 1, 0, 16 } }, { 1, 0, 17 } },
+	{ 7, { { 1, 0, 13 } }, { 1, 0, 17 } },
+	{ 2, { { 1, 0, 24 } }, { 1, 0, 21 } },
+	{ 2, { { 1, 0, 13 } }, { 1, 0, 17 } },
+	{ 23, { { -1, 0, 22 } }, { -1, 0, 19 } },
+	{ 19, { { -1, 0, 23 } }, { -1, 0, 21 } },
+	{ 6, { { -1, 0, 22 } }, { -1, 0, 24 } },
+	{ 6, { { -1, 0, 23 } }, { -1, 0, 21 } },
+	{ 1, { { 0, 1, 2 } }, { 0, 1, 7 } },
+	{ 6, { { 0, 1, 18 } }, { 0, 1, 21 } },
+	{ 18, { { 0, 1, 2 } }, { 0, 1, 7 } },
+	{ 6, { { 0, 1, 2 } }, { 0, 1, 7 } },
+	{ 21, { { 0, 1, 2 } }, { 0, 1, 7 } },
+	{ 6, { { 0, 1, 22 } }, { 0, 1, 24 } },
+	{ 6, { { 0, 1, 13 } }, { 0, 1, 16 } },
+	{ 1, { { 0, 1, 13 } }, { 0, 1, 16 } },
+	{ 13, { { 0, 1, 16 } }, { 0, 1, 17 } },
+	{ 6, { { 0, -1, 22 } }, { 0, -1, 7 } },
+	{ 6, { { 0, -1, 22 } }, { 0, -1, 24 } },
+	{ 7, { { 0, -1, 24 } }, { 0, -1, 21 } },
+	{ 18, { { 0, -1, 24 } }, { 0, -1, 21 } },
+};
+constexpr auto L5TileFix2 = CompileTileRules(L5TileFixRules2);
+
+constexpr TileRule L5TileFixRules3[] = {
+	{ 4, { { 0, 1, 2 } }, { 0, 1, 7 } },
+	{ 2, { { 1, 0, 19 } }, { 1, 0, 21 } },
+	{ 18, { { 0, 1, 22 } }, { 0, 1, 20 } },
+};
+constexpr auto L5TileFix3 = CompileTileRules(L5TileFixRules3);
+
 static void L5tileFix()
 {
-	int i, j;
-
 	// BUGFIX: Bounds checks are required in all loop bodies.
 	// See https://github.com/diasurgical/devilutionX/pull/401
 
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 2 && GetDungeon(i + 1, j) == 22)
-				SetDungeon(i + 1, j, 23);
-			if (GetDungeon(i, j) == 13 && GetDungeon(i + 1, j) == 22)
-				SetDungeon(i + 1, j, 18);
-			if (GetDungeon(i, j) == 13 && GetDungeon(i + 1, j) == 2)
-				SetDungeon(i + 1, j, 7);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i + 1, j) == 22)
-				SetDungeon(i + 1, j, 24);
-			if (GetDungeon(i, j) == 1 && GetDungeon(i, j + 1) == 22)
-				SetDungeon(i, j + 1, 24);
-			if (GetDungeon(i, j) == 13 && GetDungeon(i, j + 1) == 1)
-				SetDungeon(i, j + 1, 6);
-			if (GetDungeon(i, j) == 13 && GetDungeon(i, j + 1) == 22)
-				SetDungeon(i, j + 1, 19);
-		}
-	}
-
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 13 && GetDungeon(i + 1, j) == 19)
-				SetDungeon(i + 1, j, 21);
-			if (GetDungeon(i, j) == 13 && GetDungeon(i + 1, j) == 22)
-				SetDungeon(i + 1, j, 20);
-			if (GetDungeon(i, j) == 7 && GetDungeon(i + 1, j) == 22)
-				SetDungeon(i + 1, j, 23);
-			if (GetDungeon(i, j) == 13 && GetDungeon(i + 1, j) == 24)
-				SetDungeon(i + 1, j, 21);
-			if (GetDungeon(i, j) == 19 && GetDungeon(i + 1, j) == 22)
-				SetDungeon(i + 1, j, 20);
-			if (GetDungeon(i, j) == 2 && GetDungeon(i + 1, j) == 19)
-				SetDungeon(i + 1, j, 21);
-			if (GetDungeon(i, j) == 19 && GetDungeon(i + 1, j) == 1)
-				SetDungeon(i + 1, j, 6);
-			if (GetDungeon(i, j) == 7 && GetDungeon(i + 1, j) == 19)
-				SetDungeon(i + 1, j, 21);
-			if (GetDungeon(i, j) == 2 && GetDungeon(i + 1, j) == 1)
-				SetDungeon(i + 1, j, 6);
-			if (GetDungeon(i, j) == 3 && GetDungeon(i + 1, j) == 22)
-				SetDungeon(i + 1, j, 24);
-			if (GetDungeon(i, j) == 21 && GetDungeon(i + 1, j) == 1)
-				SetDungeon(i + 1, j, 6);
-			if (GetDungeon(i, j) == 7 && GetDungeon(i + 1, j) == 1)
-				SetDungeon(i + 1, j, 6);
-			if (GetDungeon(i, j) == 7 && GetDungeon(i + 1, j) == 24)
-				SetDungeon(i + 1, j, 21);
-			if (GetDungeon(i, j) == 4 && GetDungeon(i + 1, j) == 16)
-				SetDungeon(i + 1, j, 17);
-			if (GetDungeon(i, j) == 7 && GetDungeon(i + 1, j) == 13)
-				SetDungeon(i + 1, j, 17);
-			if (GetDungeon(i, j) == 2 && GetDungeon(i + 1, j) == 24)
-				SetDungeon(i + 1, j, 21);
-			if (GetDungeon(i, j) == 2 && GetDungeon(i + 1, j) == 13)
-				SetDungeon(i + 1, j, 17);
-			if (GetDungeon(i, j) == 23 && GetDungeon(i - 1, j) == 22)
-				SetDungeon(i - 1, j, 19);
-			if (GetDungeon(i, j) == 19 && GetDungeon(i - 1, j) == 23)
-				SetDungeon(i - 1, j, 21);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i - 1, j) == 22)
-				SetDungeon(i - 1, j, 24);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i - 1, j) == 23)
-				SetDungeon(i - 1, j, 21);
-			if (GetDungeon(i, j) == 1 && GetDungeon(i, j + 1) == 2)
-				SetDungeon(i, j + 1, 7);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i, j + 1) == 18)
-				SetDungeon(i, j + 1, 21);
-			if (GetDungeon(i, j) == 18 && GetDungeon(i, j + 1) == 2)
-				SetDungeon(i, j + 1, 7);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i, j + 1) == 2)
-				SetDungeon(i, j + 1, 7);
-			if (GetDungeon(i, j) == 21 && GetDungeon(i, j + 1) == 2)
-				SetDungeon(i, j + 1, 7);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i, j + 1) == 22)
-				SetDungeon(i, j + 1, 24);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i, j + 1) == 13)
-				SetDungeon(i, j + 1, 16);
-			if (GetDungeon(i, j) == 1 && GetDungeon(i, j + 1) == 13)
-				SetDungeon(i, j + 1, 16);
-			if (GetDungeon(i, j) == 13 && GetDungeon(i, j + 1) == 16)
-				SetDungeon(i, j + 1, 17);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i, j - 1) == 22)
-				SetDungeon(i, j - 1, 7);
-			if (GetDungeon(i, j) == 6 && GetDungeon(i, j - 1) == 22)
-				SetDungeon(i, j - 1, 24);
-			if (GetDungeon(i, j) == 7 && GetDungeon(i, j - 1) == 24)
-				SetDungeon(i, j - 1, 21);
-			if (GetDungeon(i, j) == 18 && GetDungeon(i, j - 1) == 24)
-				SetDungeon(i, j - 1, 21);
-		}
-	}
-
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 4 && GetDungeon(i, j + 1) == 2)
-				SetDungeon(i, j + 1, 7);
-			if (GetDungeon(i, j) == 2 && GetDungeon(i + 1, j) == 19)
-				SetDungeon(i + 1, j, 21);
-			if (GetDungeon(i, j) == 18 && GetDungeon(i, j + 1) == 22)
-				SetDungeon(i, j + 1, 20);
-		}
-	}
+	ApplyTileRules(L5TileFix1, dungeon, TileAccess::Checked);
+	ApplyTileRules(L5TileFix2, dungeon, TileAccess::Checked);
+	ApplyTileRules(L5TileFix3, dungeon, TileAccess::Checked);
 }
 
 #ifdef HELLFIRE
@@ -2059,7 +2020,7 @@ static void DRLG_L5Subs()
 	for (y = 0; y < DMAXY; y++) {
 		for (x = 0; x < DMAXX; x++) {
 			if (random_(0, 4) == 0) {
-				BYTE c = L5BTYPES[GetDungeon(x, y)];
+				BYTE c = L5BTYPES[dungeon[x][y]];
 
 				if (c && !L5dflags[x][y]) {
 					rv = random_(0, 16);
@@ -2086,7 +2047,7 @@ static void DRLG_L5Subs()
 						else
 							SetDungeon(x + 1, y, 92);
 					}
-					SetDungeon(x, y, i);
+					dungeon[x][y] = i;
 				}
 			}
 		}
@@ -2412,49 +2373,6 @@ void drlg_l1_set_corner_room(int rx1, int ry1)
 }
 #endif
 
-static void DRLG_L5FTVR(int i, int j, int x, int y, int d)
-{
-	if (dTransVal[x][y] || GetDungeon(i, j) != 13) {
-		if (d == 1) {
-			dTransVal[x][y] = TransVal;
-			dTransVal[x][y + 1] = TransVal;
-		}
-		if (d == 2) {
-			dTransVal[x + 1][y] = TransVal;
-			dTransVal[x + 1][y + 1] = TransVal;
-		}
-		if (d == 3) {
-			dTransVal[x][y] = TransVal;
-			dTransVal[x + 1][y] = TransVal;
-		}
-		if (d == 4) {
-			dTransVal[x][y + 1] = TransVal;
-			dTransVal[x + 1][y + 1] = TransVal;
-		}
-		if (d == 5)
-			dTransVal[x + 1][y + 1] = TransVal;
-		if (d == 6)
-			dTransVal[x][y + 1] = TransVal;
-		if (d == 7)
-			dTransVal[x + 1][y] = TransVal;
-		if (d == 8)
-			dTransVal[x][y] = TransVal;
-	} else {
-		dTransVal[x][y] = TransVal;
-		dTransVal[x + 1][y] = TransVal;
-		dTransVal[x][y + 1] = TransVal;
-		dTransVal[x + 1][y + 1] = TransVal;
-		DRLG_L5FTVR(i + 1, j, x + 2, y, 1);
-		DRLG_L5FTVR(i - 1, j, x - 2, y, 2);
-		DRLG_L5FTVR(i, j + 1, x, y + 2, 3);
-		DRLG_L5FTVR(i, j - 1, x, y - 2, 4);
-		DRLG_L5FTVR(i - 1, j - 1, x - 2, y - 2, 5);
-		DRLG_L5FTVR(i + 1, j - 1, x + 2, y - 2, 6);
-		DRLG_L5FTVR(i - 1, j + 1, x - 2, y + 2, 7);
-		DRLG_L5FTVR(i + 1, j + 1, x + 2, y + 2, 8);
-	}
-}
-
 static void DRLG_L5FloodTVal()
 {
 	int xx, yy, i, j;
@@ -2465,8 +2383,8 @@ static void DRLG_L5FloodTVal()
 		xx = 16;
 
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 13 && !dTransVal[xx][yy]) {
-				DRLG_L5FTVR(i, j, xx, yy, 0);
+			if (dungeon[i][j] == 13 && !dTransVal[xx][yy]) {
+				DRLG_FloodTransVal(i, j, xx, yy, 13);
 				TransVal++;
 			}
 			xx += 2;
@@ -2486,24 +2404,24 @@ static void DRLG_L5TransFix()
 
 		for (i = 0; i < DMAXX; i++) {
 			// BUGFIX: Should check for `j > 0` first.
-			if (GetDungeon(i, j) == 23 && GetDungeon(i, j - 1) == 18) {
+			if (dungeon[i][j] == 23 && GetDungeon(i, j - 1) == 18) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
 			// BUGFIX: Should check for `i + 1 < DMAXY` first.
-			if (GetDungeon(i, j) == 24 && GetDungeon(i + 1, j) == 19) {
+			if (dungeon[i][j] == 24 && GetDungeon(i + 1, j) == 19) {
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 18) {
+			if (dungeon[i][j] == 18) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 19) {
+			if (dungeon[i][j] == 19) {
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 20) {
+			if (dungeon[i][j] == 20) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
@@ -2522,51 +2440,51 @@ static void DRLG_L5DirtFix()
 	if (currlevel < 21) {
 		for (j = 0; j < DMAXY - 1; j++) {
 			for (i = 0; i < DMAXX - 1; i++) {
-				if (GetDungeon(i, j) == 21 && GetDungeon(i + 1, j) != 19)
-					SetDungeon(i, j, 202);
-				if (GetDungeon(i, j) == 19 && GetDungeon(i + 1, j) != 19)
-					SetDungeon(i, j, 200);
-				if (GetDungeon(i, j) == 24 && GetDungeon(i + 1, j) != 19)
-					SetDungeon(i, j, 205);
-				if (GetDungeon(i, j) == 18 && GetDungeon(i, j + 1) != 18)
-					SetDungeon(i, j, 199);
-				if (GetDungeon(i, j) == 21 && GetDungeon(i, j + 1) != 18)
-					SetDungeon(i, j, 202);
-				if (GetDungeon(i, j) == 23 && GetDungeon(i, j + 1) != 18)
-					SetDungeon(i, j, 204);
+				if (dungeon[i][j] == 21 && dungeon[i + 1][j] != 19)
+					dungeon[i][j] = 202;
+				if (dungeon[i][j] == 19 && dungeon[i + 1][j] != 19)
+					dungeon[i][j] = 200;
+				if (dungeon[i][j] == 24 && dungeon[i + 1][j] != 19)
+					dungeon[i][j] = 205;
+				if (dungeon[i][j] == 18 && dungeon[i][j + 1] != 18)
+					dungeon[i][j] = 199;
+				if (dungeon[i][j] == 21 && dungeon[i][j + 1] != 18)
+					dungeon[i][j] = 202;
+				if (dungeon[i][j] == 23 && dungeon[i][j + 1] != 18)
+					dungeon[i][j] = 204;
 			}
 		}
 	} else {
 		for (j = 0; j < DMAXY - 1; j++) {
 			for (i = 0; i < DMAXX - 1; i++) {
-				if (GetDungeon(i, j) == 19)
-					SetDungeon(i, j, 83);
-				if (GetDungeon(i, j) == 21)
-					SetDungeon(i, j, 85);
-				if (GetDungeon(i, j) == 23)
-					SetDungeon(i, j, 87);
-				if (GetDungeon(i, j) == 24)
-					SetDungeon(i, j, 88);
-				if (GetDungeon(i, j) == 18)
-					SetDungeon(i, j, 82);
+				if (dungeon[i][j] == 19)
+					dungeon[i][j] = 83;
+				if (dungeon[i][j] == 21)
+					dungeon[i][j] = 85;
+				if (dungeon[i][j] == 23)
+					dungeon[i][j] = 87;
+				if (dungeon[i][j] == 24)
+					dungeon[i][j] = 88;
+				if (dungeon[i][j] == 18)
+					dungeon[i][j] = 82;
 			}
 		}
 	}
 #else
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 21 && GetDungeon(i + 1, j) != 19)
-				SetDungeon(i, j, 202);
-			if (GetDungeon(i, j) == 19 && GetDungeon(i + 1, j) != 19)
-				SetDungeon(i, j, 200);
-			if (GetDungeon(i, j) == 24 && GetDungeon(i + 1, j) != 19)
-				SetDungeon(i, j, 205);
-			if (GetDungeon(i, j) == 18 && GetDungeon(i, j + 1) != 18)
-				SetDungeon(i, j, 199);
-			if (GetDungeon(i, j) == 21 && GetDungeon(i, j + 1) != 18)
-				SetDungeon(i, j, 202);
-			if (GetDungeon(i, j) == 23 && GetDungeon(i, j + 1) != 18)
-				SetDungeon(i, j, 204);
+			if (dungeon[i][j] == 21 && GetDungeon(i + 1, j) != 19)
+				dungeon[i][j] = 202;
+			if (dungeon[i][j] == 19 && GetDungeon(i + 1, j) != 19)
+				dungeon[i][j] = 200;
+			if (dungeon[i][j] == 24 && GetDungeon(i + 1, j) != 19)
+				dungeon[i][j] = 205;
+			if (dungeon[i][j] == 18 && GetDungeon(i, j + 1) != 18)
+				dungeon[i][j] = 199;
+			if (dungeon[i][j] == 21 && GetDungeon(i, j + 1) != 18)
+				dungeon[i][j] = 202;
+			if (dungeon[i][j] == 23 && GetDungeon(i, j + 1) != 18)
+				dungeon[i][j] = 204;
 		}
 	}
 #endif
@@ -2578,12 +2496,12 @@ static void DRLG_L5CornerFix()
 
 	for (j = 1; j < DMAXY - 1; j++) {
 		for (i = 1; i < DMAXX - 1; i++) {
-			if (!(L5dflags[i][j] & DLRG_PROTECTED) && GetDungeon(i, j) == 17 && GetDungeon(i - 1, j) == 13 && GetDungeon(i, j - 1) == 1) {
-				SetDungeon(i, j, 16);
+			if (!(L5dflags[i][j] & DLRG_PROTECTED) && dungeon[i][j] == 17 && dungeon[i - 1][j] == 13 && dungeon[i][j - 1] == 1) {
+				dungeon[i][j] = 16;
 				L5dflags[i][j - 1] &= DLRG_PROTECTED; // BUGFIX: Should be |= or it will clear all flags
 			}
-			if (GetDungeon(i, j) == 202 && GetDungeon(i + 1, j) == 13 && GetDungeon(i, j + 1) == 1) {
-				SetDungeon(i, j, 8);
+			if (dungeon[i][j] == 202 && dungeon[i + 1][j] == 13 && dungeon[i][j + 1] == 1) {
+				dungeon[i][j] = 8;
 			}
 		}
 	}
@@ -2748,7 +2666,7 @@ static std::optional<uint32_t> DRLG_L5(int entry, DungeonMode mode)
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 64) {
+			if (dungeon[i][j] == 64) {
 				int xx = 2 * i + 16; /* todo: fix loop */
 				int yy = 2 * j + 16;
 				DRLG_CopyTrans(xx, yy + 1, xx, yy);
@@ -2837,7 +2755,7 @@ static std::optional<uint32_t> DRLG_L5(int entry, DungeonMode mode)
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			pdungeon[i][j] = GetDungeon(i, j);
+			pdungeon[i][j] = dungeon[i][j];
 		}
 	}
 
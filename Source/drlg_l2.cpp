@@ -6,8 +6,13 @@
 #ifndef SPAWN
 #include "all.h"
 
+#include <array>
+#include <bit>
 #include <iostream>
 
+#include "mapGen/miniSetIndex.h"
+#include "mapGen/tileRules.h"
+
 int nSx1;
 int nSy1;
 int nSx2;
@@ -16,6 +21,8 @@ int nRoomCnt;
 BYTE predungeon[DMAXX][DMAXY];
 ROOMNODE RoomList[81];
 HALLNODE *pHallList;
+/** Last hall in pHallList, new halls are appended after it */
+HALLNODE *pHallTail;
 
 int Area_Min = 2;
 int Room_Max = 10;
@@ -1521,7 +1528,7 @@ BYTE CTRDOOR8[] = {
 	// clang-format on
 };
 
-int Patterns[100][10] = {
+constexpr int Patterns[100][10] = {
 	{ 0, 0, 0, 0, 0, 0, 0, 0, 0, 3 },
 	{ 0, 0, 0, 0, 2, 0, 0, 0, 0, 3 },
 	{ 0, 7, 0, 0, 1, 0, 0, 5, 0, 2 },
@@ -1626,22 +1633,19 @@ int Patterns[100][10] = {
 
 static BYTE GetPreDungeon(int x, int y)
 {
-	if (x < 0 || y < 0 || x >= DMAXX || y >= DMAXY) {
-		int index = x * DMAXY + y;
-		x = index / DMAXY;
-		y = index % DMAXY;
-		if (x < 0 || y < 0 || x >= DMAXX) {
-			oobread = true;
-			return 0;
-		}
+	unsigned index = x * DMAXY + y;
+	if (index >= DMAXX * DMAXY) {
+		oobread = true;
+		return 0;
 	}
-	return predungeon[x][y];
+	return predungeon[index / DMAXY][index % DMAXY];
 }
 
 static BOOL DRLG_L2PlaceMiniSet(BYTE *miniset, int tmin, int tmax, int cx, int cy, BOOL setview, int ldir)
 {
-	int sx, sy, sw, sh, xx, yy, i, ii, numt, bailcnt;
+	int sx, sy, sw, sh, xx, yy, i, ii, numt, bailcnt, skip;
 	BOOL found;
+	MiniSetIndex index;
 
 	sw = miniset[0];
 	sh = miniset[1];
@@ -1652,11 +1656,28 @@ static BOOL DRLG_L2PlaceMiniSet(BYTE *miniset, int tmin, int tmax, int cx, int c
 		numt = random_(0, tmax - tmin) + tmin;
 	}
 
+	index.Build(miniset, dungeon, (const BYTE(*)[DMAXY])dflags);
+	index.Exclude(nSx1, nSy1, nSx2, nSy2);
+	if (cx != -1) {
+		index.Stop(cx - sw, 0, cx + 12, DMAXY);
+	}
+	if (cy != -1) {
+		index.Stop(0, cy - sh, DMAXX, cy + 12);
+	}
+
 	for (i = 0; i < numt; i++) {
 		sx = random_(0, DMAXX - sw);
 		sy = random_(0, DMAXY - sh);
 		found = FALSE;
 		for (bailcnt = 0; !found && bailcnt < 200; bailcnt++) {
+			// Jump over the positions that would only be stepped over
+			skip = index.Distance(sx, sy, 200 - bailcnt);
+			bailcnt += skip;
+			if (bailcnt >= 200) {
+				break;
+			}
+			index.Advance(sx, sy, skip);
+
 			found = TRUE;
 			if (sx >= nSx1 && sx <= nSx2 && sy >= nSy1 && sy <= nSy2) {
 				found = FALSE;
@@ -1671,17 +1692,8 @@ static BOOL DRLG_L2PlaceMiniSet(BYTE *miniset, int tmin, int tmax, int cx, int c
 				sy = random_(0, DMAXY - sh);
 				found = FALSE;
 			}
-			ii = 2;
-			for (yy = 0; yy < sh && found == TRUE; yy++) {
-				for (xx = 0; xx < sw && found == TRUE; xx++) {
-					if (miniset[ii] != 0 && GetDungeon(xx + sx, yy + sy) != miniset[ii]) {
-						found = FALSE;
-					}
-					if (dflags[xx + sx][yy + sy] != 0) {
-						found = FALSE;
-					}
-					ii++;
-				}
+			if (found == TRUE && !index.Matches(sx, sy)) {
+				found = FALSE;
 			}
 			if (!found) {
 				sx++;
@@ -1706,6 +1718,7 @@ static BOOL DRLG_L2PlaceMiniSet(BYTE *miniset, int tmin, int tmax, int cx, int c
 				ii++;
 			}
 		}
+		index.Update(sx, sy);
 	}
 
 	if (setview == TRUE) {
@@ -1726,29 +1739,22 @@ static BOOL DRLG_L2PlaceMiniSet(BYTE *miniset, int tmin, int tmax, int cx, int c
 
 static void DRLG_L2PlaceRndSet(BYTE *miniset, int rndper)
 {
-	int sx, sy, sw, sh, xx, yy, ii, kk;
+	int sx, sy, sw, sh, xx, yy, kk;
 	BOOL found;
+	MiniSetIndex index;
 
 	sw = miniset[0];
 	sh = miniset[1];
+	index.Build(miniset, dungeon, (const BYTE(*)[DMAXY])dflags);
 
 	for (sy = 0; sy < DMAXY - sh; sy++) {
 		for (sx = 0; sx < DMAXX - sw; sx++) {
 			found = TRUE;
-			ii = 2;
 			if (sx >= nSx1 && sx <= nSx2 && sy >= nSy1 && sy <= nSy2) {
 				found = FALSE;
 			}
-			for (yy = 0; yy < sh && found == TRUE; yy++) {
-				for (xx = 0; xx < sw && found == TRUE; xx++) {
-					if (miniset[ii] != 0 && GetDungeon(xx + sx, yy + sy) != miniset[ii]) {
-						found = FALSE;
-					}
-					if (dflags[xx + sx][yy + sy] != 0) {
-						found = FALSE;
-					}
-					ii++;
-				}
+			if (found == TRUE && !index.Matches(sx, sy)) {
+				found = FALSE;
 			}
 			kk = sw * sh + 2;
 			if (found == TRUE) {
@@ -1770,6 +1776,7 @@ static void DRLG_L2PlaceRndSet(BYTE *miniset, int rndper)
 						kk++;
 					}
 				}
+				index.Update(sx, sy);
 			}
 		}
 	}
@@ -1783,7 +1790,7 @@ static void DRLG_L2Subs()
 	for (y = 0; y < DMAXY; y++) {
 		for (x = 0; x < DMAXX; x++) {
 			if ((x < nSx1 || x > nSx2) && (y < nSy1 || y > nSy2) && random_(0, 4) == 0) { // BUGFIX: Should be (x < nSx1 || x > nSx2 || y < nSy1 || y >= nSy2)
-				c = BTYPESL2[GetDungeon(x, y)];
+				c = BTYPESL2[dungeon[x][y]];
 				if (c != 0) {
 					rv = random_(0, 16);
 					k = -1;
@@ -1805,7 +1812,7 @@ static void DRLG_L2Subs()
 						}
 					}
 					if (j < y + 3) {
-						SetDungeon(x, y, k);
+						dungeon[x][y] = k;
 					}
 				}
 			}
@@ -1813,6 +1820,10 @@ static void DRLG_L2Subs()
 	}
 }
 
+/**
+ * The patterns compare the BSTYPESL2 classes of the tiles, which the exact tile checks of
+ * the tile rule tables can't express, and with only two of them there is nothing to index.
+ */
 static void DRLG_L2Shadows()
 {
 	int x, y, i;
@@ -1821,10 +1832,10 @@ static void DRLG_L2Shadows()
 
 	for (y = 1; y < DMAXY; y++) {
 		for (x = 1; x < DMAXX; x++) {
-			sd[0][0] = BSTYPESL2[GetDungeon(x, y)];
-			sd[1][0] = BSTYPESL2[GetDungeon(x - 1, y)];
-			sd[0][1] = BSTYPESL2[GetDungeon(x, y - 1)];
-			sd[1][1] = BSTYPESL2[GetDungeon(x - 1, y - 1)];
+			sd[0][0] = BSTYPESL2[dungeon[x][y]];
+			sd[1][0] = BSTYPESL2[dungeon[x - 1][y]];
+			sd[0][1] = BSTYPESL2[dungeon[x][y - 1]];
+			sd[1][1] = BSTYPESL2[dungeon[x - 1][y - 1]];
 			for (i = 0; i < 2; i++) {
 				if (SPATSL2[i].strig == sd[0][0]) {
 					patflag = TRUE;
@@ -1839,13 +1850,13 @@ static void DRLG_L2Shadows()
 					}
 					if (patflag == TRUE) {
 						if (SPATSL2[i].nv1 != 0) {
-							SetDungeon(x - 1, y - 1, SPATSL2[i].nv1);
+							dungeon[x - 1][y - 1] = SPATSL2[i].nv1;
 						}
 						if (SPATSL2[i].nv2 != 0) {
-							SetDungeon(x, y - 1, SPATSL2[i].nv2);
+							dungeon[x][y - 1] = SPATSL2[i].nv2;
 						}
 						if (SPATSL2[i].nv3 != 0) {
-							SetDungeon(x - 1, y, SPATSL2[i].nv3);
+							dungeon[x - 1][y] = SPATSL2[i].nv3;
 						}
 					}
 				}
@@ -2006,30 +2017,20 @@ static void PlaceHallExt(int nX, int nY)
 
 static void AddHall(int nX1, int nY1, int nX2, int nY2, int nHd)
 {
-	HALLNODE *p1, *p2;
-
-	if (pHallList == NULL) {
-		pHallList = (HALLNODE *)DiabloAllocPtr(sizeof(*pHallList));
-		pHallList->nHallx1 = nX1;
-		pHallList->nHally1 = nY1;
-		pHallList->nHallx2 = nX2;
-		pHallList->nHally2 = nY2;
-		pHallList->nHalldir = nHd;
-		pHallList->pNext = NULL;
-	} else {
-		p1 = (HALLNODE *)DiabloAllocPtr(sizeof(*pHallList));
-		p1->nHallx1 = nX1;
-		p1->nHally1 = nY1;
-		p1->nHallx2 = nX2;
-		p1->nHally2 = nY2;
-		p1->nHalldir = nHd;
-		p1->pNext = NULL;
-		p2 = pHallList;
-		while (p2->pNext != NULL) {
-			p2 = p2->pNext;
-		}
-		p2->pNext = p1;
-	}
+	HALLNODE *p1;
+
+	p1 = levelArena.New<HALLNODE>();
+	p1->nHallx1 = nX1;
+	p1->nHally1 = nY1;
+	p1->nHallx2 = nX2;
+	p1->nHally2 = nY2;
+	p1->nHalldir = nHd;
+	p1->pNext = NULL;
+	if (pHallList == NULL)
+		pHallList = p1;
+	else
+		pHallTail->pNext = p1;
+	pHallTail = p1;
 }
 
 /**
@@ -2182,7 +2183,6 @@ static void GetHall(int *nX1, int *nY1, int *nX2, int *nY2, int *nHd)
 	*nX2 = pHallList->nHallx2;
 	*nY2 = pHallList->nHally2;
 	*nHd = pHallList->nHalldir;
-	MemFreeDbg(pHallList);
 	pHallList = p1;
 }
 
@@ -2342,102 +2342,153 @@ static void ConnectHall(int nX1, int nY1, int nX2, int nY2, int nHd)
 	}
 }
 
-static void DoPatternCheck(int i, int j)
+/** Kinds of predungeon tiles told apart by Patterns */
+enum pattern_class : uint8_t {
+	PATTERN_WALL,
+	PATTERN_FLOOR,
+	PATTERN_DOOR,
+	PATTERN_EMPTY,
+	PATTERN_OTHER,
+	/** Outside the map, matches any pattern entry */
+	PATTERN_OUTSIDE,
+	PATTERN_CLASSES,
+};
+
+constexpr int PatternWords = 2;
+
+/**
+ * For each of the 9 neighbours and each tile class, bit k is set if Patterns[k]
+ * accepts that class at that neighbour.
+ */
+struct PatternTable {
+	uint64_t masks[9][PATTERN_CLASSES][PatternWords];
+};
+
+constexpr bool PatternAccepts(int entry, int tileClass)
 {
-	int k, l, x, y, nOk;
-
-	for (k = 0; Patterns[k][4] != 255; k++) {
-		x = i - 1;
-		y = j - 1;
-		nOk = 254;
-		for (l = 0; l < 9 && nOk == 254; l++) {
-			nOk = 255;
-			if (l == 3 || l == 6) {
-				y++;
-				x = i - 1;
-			}
-			if (x >= 0 && x < DMAXX && y >= 0 && y < DMAXY) {
-				switch (Patterns[k][l]) {
-				case 0:
-					nOk = 254;
-					break;
-				case 1:
-					if (predungeon[x][y] == 35) {
-						nOk = 254;
-					}
-					break;
-				case 2:
-					if (predungeon[x][y] == 46) {
-						nOk = 254;
-					}
-					break;
-				case 4:
-					if (predungeon[x][y] == 32) {
-						nOk = 254;
-					}
-					break;
-				case 3:
-					if (predungeon[x][y] == 68) {
-						nOk = 254;
-					}
-					break;
-				case 5:
-					if (predungeon[x][y] == 68 || predungeon[x][y] == 46) {
-						nOk = 254;
-					}
-					break;
-				case 6:
-					if (predungeon[x][y] == 68 || predungeon[x][y] == 35) {
-						nOk = 254;
-					}
-					break;
-				case 7:
-					if (predungeon[x][y] == 32 || predungeon[x][y] == 46) {
-						nOk = 254;
-					}
-					break;
-				case 8:
-					if (predungeon[x][y] == 68 || predungeon[x][y] == 35 || predungeon[x][y] == 46) {
-						nOk = 254;
-					}
-					break;
-				}
-			} else {
-				nOk = 254;
+	if (tileClass == PATTERN_OUTSIDE)
+		return true;
+
+	switch (entry) {
+	case 0:
+		return true;
+	case 1:
+		return tileClass == PATTERN_WALL;
+	case 2:
+		return tileClass == PATTERN_FLOOR;
+	case 3:
+		return tileClass == PATTERN_DOOR;
+	case 4:
+		return tileClass == PATTERN_EMPTY;
+	case 5:
+		return tileClass == PATTERN_DOOR || tileClass == PATTERN_FLOOR;
+	case 6:
+		return tileClass == PATTERN_DOOR || tileClass == PATTERN_WALL;
+	case 7:
+		return tileClass == PATTERN_EMPTY || tileClass == PATTERN_FLOOR;
+	case 8:
+		return tileClass == PATTERN_DOOR || tileClass == PATTERN_WALL || tileClass == PATTERN_FLOOR;
+	}
+
+	return false;
+}
+
+constexpr PatternTable BuildPatternTable()
+{
+	PatternTable table {};
+
+	for (int k = 0; Patterns[k][4] != 255; k++) {
+		for (int l = 0; l < 9; l++) {
+			for (int c = 0; c < PATTERN_CLASSES; c++) {
+				if (PatternAccepts(Patterns[k][l], c))
+					table.masks[l][c][k / 64] |= 1ULL << (k % 64);
 			}
-			x++;
-		}
-		if (nOk == 254) {
-			SetDungeon(i, j, Patterns[k][9]);
 		}
 	}
+
+	return table;
 }
 
-static void L2TileFix()
+constexpr int CountPatterns()
 {
-	int i, j;
+	int k = 0;
+	while (Patterns[k][4] != 255)
+		k++;
+	return k;
+}
 
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 1 && GetDungeon(i, j + 1) == 3) {
-				SetDungeon(i, j + 1, 1);
-			}
-			if (GetDungeon(i, j) == 3 && GetDungeon(i, j + 1) == 1) {
-				SetDungeon(i, j + 1, 3);
-			}
-			if (GetDungeon(i, j) == 3 && GetDungeon(i + 1, j) == 7) {
-				SetDungeon(i + 1, j, 3);
-			}
-			if (GetDungeon(i, j) == 2 && GetDungeon(i + 1, j) == 3) {
-				SetDungeon(i + 1, j, 2);
-			}
-			if (GetDungeon(i, j) == 11 && GetDungeon(i + 1, j) == 14) {
-				SetDungeon(i + 1, j, 16);
-			}
+static_assert(CountPatterns() <= PatternWords * 64, "PatternWords is too small for Patterns");
+
+constexpr PatternTable PatternChecks = BuildPatternTable();
+
+constexpr std::array<BYTE, 256> BuildPatternClasses()
+{
+	std::array<BYTE, 256> classes {};
+
+	for (int i = 0; i < 256; i++)
+		classes[i] = PATTERN_OTHER;
+	classes[35] = PATTERN_WALL;
+	classes[46] = PATTERN_FLOOR;
+	classes[68] = PATTERN_DOOR;
+	classes[32] = PATTERN_EMPTY;
+
+	return classes;
+}
+
+constexpr std::array<BYTE, 256> PatternClasses = BuildPatternClasses();
+
+/**
+ * @brief Apply the last entry of Patterns that matches the neighbourhood of (i, j)
+ *
+ * The patterns accepting each neighbour are looked up by the neighbour's tile class
+ * and intersected, instead of testing the patterns one by one.
+ */
+static void DoPatternCheck(int i, int j)
+{
+	int l, x, y, w;
+	BYTE tileClass;
+	uint64_t matches[PatternWords];
+
+	for (w = 0; w < PatternWords; w++) {
+		matches[w] = ~0ULL;
+	}
+
+	for (l = 0; l < 9; l++) {
+		x = i - 1 + l % 3;
+		y = j - 1 + l / 3;
+		if (x >= 0 && x < DMAXX && y >= 0 && y < DMAXY) {
+			tileClass = PatternClasses[predungeon[x][y]];
+		} else {
+			tileClass = PATTERN_OUTSIDE;
+		}
+		for (w = 0; w < PatternWords; w++) {
+			matches[w] &= PatternChecks.masks[l][tileClass][w];
+		}
+	}
+
+	for (w = PatternWords - 1; w >= 0; w--) {
+		if (matches[w] != 0) {
+			SetDungeon(i, j, Patterns[w * 64 + 63 - std::countl_zero(matches[w])][9]);
+			return;
 		}
 	}
 }
 
+/* centre, { checked neighbours }, replaced neighbour, the positions are (dx, dy) from the centre */
+constexpr TileRule L2TileFixRules1[] = {
+	{ 1, { { 0, 1, 3 } }, { 0, 1, 1 } },
+	{ 3, { { 0, 1, 1 } }, { 0, 1, 3 } },
+	{ 3, { { 1, 0, 7 } }, { 1, 0, 3 } },
+	{ 2, { { 1, 0, 3 } }, { 1, 0, 2 } },
+	{ 11, { { 1, 0, 14 } }, { 1, 0, 16 } },
+};
+constexpr auto L2TileFix1 = CompileTileRules(L2TileFixRules1);
+
+static void L2TileFix()
+{
+	ApplyTileRules(L2TileFix1, dungeon, TileAccess::Checked);
+}
+
 static BOOL DL2_Cont(BOOL x1f, BOOL y1f, BOOL x2f, BOOL y2f)
 {
 	if (x1f && x2f && y1f && y2f) {
@@ -2798,6 +2849,7 @@ static BOOL CreateDungeon()
 {
 	int i, j, nHx1, nHy1, nHx2, nHy2, nHd, ForceH, ForceW;
 	BOOL ForceHW;
+	Arena::Marker hallMark;
 
 	ForceW = 0;
 	ForceH = 0;
@@ -2829,12 +2881,15 @@ static BOOL CreateDungeon()
 		break;
 	}
 
+	// The halls are dropped again once connected, so retries reuse the same memory
+	hallMark = levelArena.Mark();
 	CreateRoom(2, 2, DMAXX - 1, DMAXY - 1, 0, 0, ForceHW, ForceH, ForceW);
 
 	while (pHallList != NULL) {
 		GetHall(&nHx1, &nHy1, &nHx2, &nHy2, &nHd);
 		ConnectHall(nHx1, nHy1, nHx2, nHy2, nHd);
 	}
+	levelArena.Rewind(hallMark);
 
 	for (j = 0; j <= DMAXY; j++) {     /// BUGFIX: change '<=' to '<'
 		for (i = 0; i <= DMAXX; i++) { /// BUGFIX: change '<=' to '<'
@@ -2895,134 +2950,7 @@ static BOOL CreateDungeon()
 
 static void DRLG_L2Pass3()
 {
-	int i, j, xx, yy;
-	long v1, v2, v3, v4, lv;
-
-	lv = 12 - 1;
-
-#ifdef USE_ASM
-	__asm {
-		mov		esi, pMegaTiles
-		mov		eax, lv
-		shl		eax, 3
-		add		esi, eax
-		xor		eax, eax
-		lodsw
-		inc		eax
-		mov		v1, eax
-		lodsw
-		inc		eax
-		mov		v2, eax
-		lodsw
-		inc		eax
-		mov		v3, eax
-		lodsw
-		inc		eax
-		mov		v4, eax
-	}
-#else
-	v1 = *((WORD *)&pMegaTiles[lv * 8] + 0) + 1;
-	v2 = *((WORD *)&pMegaTiles[lv * 8] + 1) + 1;
-	v3 = *((WORD *)&pMegaTiles[lv * 8] + 2) + 1;
-	v4 = *((WORD *)&pMegaTiles[lv * 8] + 3) + 1;
-#endif
-
-	for (j = 0; j < MAXDUNY; j += 2)
-	{
-		for (i = 0; i < MAXDUNX; i += 2) {
-			dPiece[i][j] = v1;
-			dPiece[i + 1][j] = v2;
-			dPiece[i][j + 1] = v3;
-			dPiece[i + 1][j + 1] = v4;
-		}
-	}
-
-	yy = 16;
-	for (j = 0; j < DMAXY; j++) {
-		xx = 16;
-		for (i = 0; i < DMAXX; i++) {
-			lv = GetDungeon(i, j) - 1;
-#ifdef USE_ASM
-			__asm {
-				mov		esi, pMegaTiles
-				mov		eax, lv
-				shl		eax, 3
-				add		esi, eax
-				xor		eax, eax
-				lodsw
-				inc		eax
-				mov		v1, eax
-				lodsw
-				inc		eax
-				mov		v2, eax
-				lodsw
-				inc		eax
-				mov		v3, eax
-				lodsw
-				inc		eax
-				mov		v4, eax
-			}
-#else
-			v1 = *((WORD *)&pMegaTiles[lv * 8] + 0) + 1;
-			v2 = *((WORD *)&pMegaTiles[lv * 8] + 1) + 1;
-			v3 = *((WORD *)&pMegaTiles[lv * 8] + 2) + 1;
-			v4 = *((WORD *)&pMegaTiles[lv * 8] + 3) + 1;
-#endif
-			dPiece[xx][yy] = v1;
-			dPiece[xx + 1][yy] = v2;
-			dPiece[xx][yy + 1] = v3;
-			dPiece[xx + 1][yy + 1] = v4;
-			xx += 2;
-		}
-		yy += 2;
-	}
-}
-
-static void DRLG_L2FTVR(int i, int j, int x, int y, int d)
-{
-	if (dTransVal[x][y] != 0 || GetDungeon(i, j) != 3) {
-		if (d == 1) {
-			dTransVal[x][y] = TransVal;
-			dTransVal[x][y + 1] = TransVal;
-		}
-		if (d == 2) {
-			dTransVal[x + 1][y] = TransVal;
-			dTransVal[x + 1][y + 1] = TransVal;
-		}
-		if (d == 3) {
-			dTransVal[x][y] = TransVal;
-			dTransVal[x + 1][y] = TransVal;
-		}
-		if (d == 4) {
-			dTransVal[x][y + 1] = TransVal;
-			dTransVal[x + 1][y + 1] = TransVal;
-		}
-		if (d == 5) {
-			dTransVal[x + 1][y + 1] = TransVal;
-		}
-		if (d == 6) {
-			dTransVal[x][y + 1] = TransVal;
-		}
-		if (d == 7) {
-			dTransVal[x + 1][y] = TransVal;
-		}
-		if (d == 8) {
-			dTransVal[x][y] = TransVal;
-		}
-	} else {
-		dTransVal[x][y] = TransVal;
-		dTransVal[x + 1][y] = TransVal;
-		dTransVal[x][y + 1] = TransVal;
-		dTransVal[x + 1][y + 1] = TransVal;
-		DRLG_L2FTVR(i + 1, j, x + 2, y, 1);
-		DRLG_L2FTVR(i - 1, j, x - 2, y, 2);
-		DRLG_L2FTVR(i, j + 1, x, y + 2, 3);
-		DRLG_L2FTVR(i, j - 1, x, y - 2, 4);
-		DRLG_L2FTVR(i - 1, j - 1, x - 2, y - 2, 5);
-		DRLG_L2FTVR(i + 1, j - 1, x + 2, y - 2, 6);
-		DRLG_L2FTVR(i - 1, j + 1, x - 2, y + 2, 7);
-		DRLG_L2FTVR(i + 1, j + 1, x + 2, y + 2, 8);
-	}
+	DRLG_ExpandMegaTiles(12);
 }
 
 static void DRLG_L2FloodTVal()
@@ -3033,8 +2961,8 @@ static void DRLG_L2FloodTVal()
 	for (j = 0; j < DMAXY; j++) {
 		xx = 16;
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 3 && dTransVal[xx][yy] == 0) {
-				DRLG_L2FTVR(i, j, xx, yy, 0);
+			if (dungeon[i][j] == 3 && dTransVal[xx][yy] == 0) {
+				DRLG_FloodTransVal(i, j, xx, yy, 3);
 				TransVal++;
 			}
 			xx += 2;
@@ -3051,23 +2979,23 @@ static void DRLG_L2TransFix()
 	for (j = 0; j < DMAXY; j++) {
 		xx = 16;
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 14 && GetDungeon(i, j - 1) == 10) {
+			if (dungeon[i][j] == 14 && GetDungeon(i, j - 1) == 10) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 15 && GetDungeon(i + 1, j) == 11) {
+			if (dungeon[i][j] == 15 && GetDungeon(i + 1, j) == 11) {
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 10) {
+			if (dungeon[i][j] == 10) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 11) {
+			if (dungeon[i][j] == 11) {
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 16) {
+			if (dungeon[i][j] == 16) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
@@ -3084,23 +3012,23 @@ static void L2DirtFix()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 13 && GetDungeon(i + 1, j) != 11) {
-				SetDungeon(i, j, 146);
+			if (dungeon[i][j] == 13 && GetDungeon(i + 1, j) != 11) {
+				dungeon[i][j] = 146;
 			}
-			if (GetDungeon(i, j) == 11 && GetDungeon(i + 1, j) != 11) {
-				SetDungeon(i, j, 144);
+			if (dungeon[i][j] == 11 && GetDungeon(i + 1, j) != 11) {
+				dungeon[i][j] = 144;
 			}
-			if (GetDungeon(i, j) == 15 && GetDungeon(i + 1, j) != 11) {
-				SetDungeon(i, j, 148);
+			if (dungeon[i][j] == 15 && GetDungeon(i + 1, j) != 11) {
+				dungeon[i][j] = 148;
 			}
-			if (GetDungeon(i, j) == 10 && GetDungeon(i, j + 1) != 10) {
-				SetDungeon(i, j, 143);
+			if (dungeon[i][j] == 10 && GetDungeon(i, j + 1) != 10) {
+				dungeon[i][j] = 143;
 			}
-			if (GetDungeon(i, j) == 13 && GetDungeon(i, j + 1) != 10) {
-				SetDungeon(i, j, 146);
+			if (dungeon[i][j] == 13 && GetDungeon(i, j + 1) != 10) {
+				dungeon[i][j] = 146;
 			}
-			if (GetDungeon(i, j) == 14 && GetDungeon(i, j + 1) != 15) {
-				SetDungeon(i, j, 147);
+			if (dungeon[i][j] == 14 && GetDungeon(i, j + 1) != 15) {
+				dungeon[i][j] = 147;
 			}
 		}
 	}
@@ -3113,11 +3041,11 @@ void L2LockoutFix()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 4 && GetDungeon(i - 1, j) != 3) {
-				SetDungeon(i, j, 1);
+			if (dungeon[i][j] == 4 && GetDungeon(i - 1, j) != 3) {
+				dungeon[i][j] = 1;
 			}
-			if (GetDungeon(i, j) == 5 && GetDungeon(i, j - 1) != 3) {
-				SetDungeon(i, j, 2);
+			if (dungeon[i][j] == 5 && GetDungeon(i, j - 1) != 3) {
+				dungeon[i][j] = 2;
 			}
 		}
 	}
@@ -3179,11 +3107,11 @@ void L2DoorFix()
 
 	for (j = 1; j < DMAXY; j++) {
 		for (i = 1; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 4 && GetDungeon(i, j - 1) == 3) {
-				SetDungeon(i, j, 7);
+			if (dungeon[i][j] == 4 && dungeon[i][j - 1] == 3) {
+				dungeon[i][j] = 7;
 			}
-			if (GetDungeon(i, j) == 5 && GetDungeon(i - 1, j) == 3) {
-				SetDungeon(i, j, 9);
+			if (dungeon[i][j] == 5 && dungeon[i - 1][j] == 3) {
+				dungeon[i][j] = 9;
 			}
 		}
 	}
@@ -3364,7 +3292,7 @@ static std::optional<uint32_t> DRLG_L2(int entry, DungeonMode mode)
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			pdungeon[i][j] = GetDungeon(i, j);
+			pdungeon[i][j] = dungeon[i][j];
 		}
 	}
 
@@ -3376,6 +3304,7 @@ static std::optional<uint32_t> DRLG_L2(int entry, DungeonMode mode)
 
 static void DRLG_InitL2Vals()
 {
+#ifndef GENERATION_ONLY
 	int i, j, pc;
 
 	for (j = 0; j < MAXDUNY; j++) {
@@ -3411,6 +3340,7 @@ static void DRLG_InitL2Vals()
 			}
 		}
 	}
+#endif
 }
 
 void LoadL2Dungeon(const char *sFileName, int vx, int vy)
@@ -3420,11 +3350,11 @@ void LoadL2Dungeon(const char *sFileName, int vx, int vy)
 
 	InitDungeon();
 	DRLG_InitTrans();
-	pLevelMap = LoadFileInMem(sFileName, NULL);
+	pLevelMap = LoadLevelFileInMem(sFileName, NULL);
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			SetDungeon(i, j, 12);
+			dungeon[i][j] = 12;
 			dflags[i][j] = 0;
 		}
 	}
@@ -3448,8 +3378,8 @@ void LoadL2Dungeon(const char *sFileName, int vx, int vy)
 	}
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 0) {
-				SetDungeon(i, j, 12);
+			if (dungeon[i][j] == 0) {
+				dungeon[i][j] = 12;
 			}
 		}
 	}
@@ -3471,11 +3401,11 @@ void LoadPreL2Dungeon(const char *sFileName, int vx, int vy)
 
 	InitDungeon();
 	DRLG_InitTrans();
-	pLevelMap = LoadFileInMem(sFileName, NULL);
+	pLevelMap = LoadLevelFileInMem(sFileName, NULL);
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			SetDungeon(i, j, 12);
+			dungeon[i][j] = 12;
 			dflags[i][j] = 0;
 		}
 	}
@@ -3499,14 +3429,14 @@ void LoadPreL2Dungeon(const char *sFileName, int vx, int vy)
 	}
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 0) {
-				SetDungeon(i, j, 12);
+			if (dungeon[i][j] == 0) {
+				dungeon[i][j] = 12;
 			}
 		}
 	}
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			pdungeon[i][j] = GetDungeon(i, j);
+			pdungeon[i][j] = dungeon[i][j];
 		}
 	}
 
@@ -6,6 +6,9 @@
 #ifndef SPAWN
 #include "all.h"
 
+#include "mapGen/floodFill.h"
+#include "mapGen/miniSetIndex.h"
+
 /** This will be true if a lava pool has been generated for the level */
 
 BOOLEAN lavapool;
@@ -847,7 +850,7 @@ static void InitL3Dungeon()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			SetDungeon(i, j, 0);
+			dungeon[i][j] = 0;
 			dflags[i][j] = 0;
 		}
 	}
@@ -1133,7 +1136,7 @@ static int DRLG_L3GetFloorArea()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			gfa += GetDungeon(i, j);
+			gfa += dungeon[i][j];
 		}
 	}
 
@@ -1146,7 +1149,7 @@ static void DRLG_L3MakeMegas()
 
 	for (j = 0; j < DMAXY - 1; j++) {
 		for (i = 0; i < DMAXX - 1; i++) {
-			v = GetDungeon(i + 1, j + 1) + 2 * GetDungeon(i, j + 1) + 4 * GetDungeon(i + 1, j) + 8 * GetDungeon(i, j);
+			v = dungeon[i + 1][j + 1] + 2 * dungeon[i][j + 1] + 4 * dungeon[i + 1][j] + 8 * dungeon[i][j];
 			if (v == 6) {
 				rv = random_(0, 2);
 				if (rv == 0) {
@@ -1163,7 +1166,7 @@ static void DRLG_L3MakeMegas()
 					v = 14;
 				}
 			}
-			SetDungeon(i, j, L3ConvTbl[v]);
+			dungeon[i][j] = L3ConvTbl[v];
 		}
 		SetDungeon(DMAXX - 1, j, 8);
 	}
@@ -1422,106 +1425,101 @@ static void DRLG_L3River()
 	}
 }
 
-static BOOL DRLG_L3Spawn(int x, int y, int *totarea);
+/** A cell of the lava pool search and its next neighbour to visit */
+struct L3SpawnNode {
+	int x;
+	int y;
+	BYTE tile;
+	/** Reached through a wall edge rather than from a dirt tile */
+	BOOL edge;
+	int step;
+};
 
-static BOOL DRLG_L3SpawnEdge(int x, int y, int *totarea)
+/**
+ * @brief Enter a cell of the lava pool search
+ */
+static FloodStep DRLG_L3SpawnEnter(L3SpawnNode &node, int *totarea)
 {
-	BYTE i;
-	static BYTE spawntable[15] = { 0x00, 0x0A, 0x43, 0x05, 0x2c, 0x06, 0x09, 0x00, 0x00, 0x1c, 0x83, 0x06, 0x09, 0x0A, 0x05 };
-
 	if (*totarea > 40) {
-		return TRUE;
+		return FloodStep::Stop;
 	}
-	if (x < 0 || y < 0 || x >= DMAXX || y >= DMAXY) {
-		return TRUE;
+	if (node.x < 0 || node.y < 0 || node.x >= DMAXX || node.y >= DMAXY) {
+		return FloodStep::Stop;
 	}
-	if (GetDungeon(x, y) & 0x80) {
-		return FALSE;
+	if (GetDungeon(node.x, node.y) & 0x80) {
+		return FloodStep::Skip;
 	}
-	if (GetDungeon(x, y) > 15) {
-		return TRUE;
+	if (GetDungeon(node.x, node.y) > 15) {
+		return FloodStep::Stop;
 	}
 
-	i = GetDungeon(x, y);
-	SetDungeon(x, y, GetDungeon(x, y) | 0x80);
+	node.tile = GetDungeon(node.x, node.y);
+	node.step = 0;
+	SetDungeon(node.x, node.y, GetDungeon(node.x, node.y) | 0x80);
 	*totarea += 1;
 
-	if (spawntable[i] & 8 && DRLG_L3SpawnEdge(x, y - 1, totarea) == TRUE) {
-		return TRUE;
-	}
-	if (spawntable[i] & 4 && DRLG_L3SpawnEdge(x, y + 1, totarea) == TRUE) {
-		return TRUE;
-	}
-	if (spawntable[i] & 2 && DRLG_L3SpawnEdge(x + 1, y, totarea) == TRUE) {
-		return TRUE;
-	}
-	if (spawntable[i] & 1 && DRLG_L3SpawnEdge(x - 1, y, totarea) == TRUE) {
-		return TRUE;
-	}
-	if (spawntable[i] & 0x80 && DRLG_L3Spawn(x, y - 1, totarea) == TRUE) {
-		return TRUE;
-	}
-	if (spawntable[i] & 0x40 && DRLG_L3Spawn(x, y + 1, totarea) == TRUE) {
-		return TRUE;
-	}
-	if (spawntable[i] & 0x20 && DRLG_L3Spawn(x + 1, y, totarea) == TRUE) {
-		return TRUE;
-	}
-	if (spawntable[i] & 0x10 && DRLG_L3Spawn(x - 1, y, totarea) == TRUE) {
-		return TRUE;
-	}
-
-	return FALSE;
+	return FloodStep::Expand;
 }
 
-static BOOL DRLG_L3Spawn(int x, int y, int *totarea)
+/**
+ * @brief Pick the next neighbour of a cell of the lava pool search
+ *
+ * Edge cells continue along the edges in their spawn table and then in to the dirt,
+ * dirt cells (8) spread to all sides and other cells follow their edges.
+ */
+static bool DRLG_L3SpawnNext(L3SpawnNode &node, L3SpawnNode &child)
 {
-	BYTE i;
 	static BYTE spawntable[15] = { 0x00, 0x0A, 0x03, 0x05, 0x0C, 0x06, 0x09, 0x00, 0x00, 0x0C, 0x03, 0x06, 0x09, 0x0A, 0x05 };
-
-	if (*totarea > 40) {
-		return TRUE;
-	}
-	if (x < 0 || y < 0 || x >= DMAXX || y >= DMAXY) {
-		return TRUE;
-	}
-	if (GetDungeon(x, y) & 0x80) {
-		return FALSE;
-	}
-	if (GetDungeon(x, y) > 15) {
-		return TRUE;
+	static BYTE spawnedgetable[15] = { 0x00, 0x0A, 0x43, 0x05, 0x2c, 0x06, 0x09, 0x00, 0x00, 0x1c, 0x83, 0x06, 0x09, 0x0A, 0x05 };
+	/** Order the edges are followed in: up, down, right, left */
+	static const int edgeDir[4][2] = { { 0, -1 }, { 0, 1 }, { 1, 0 }, { -1, 0 } };
+	/** Order dirt spreads in: right, left, down, up */
+	static const int dirtDir[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+	int s;
+
+	while (true) {
+		s = node.step++;
+		if (node.edge) {
+			if (s >= 8) {
+				return false;
+			}
+			if (s < 4 && (spawnedgetable[node.tile] & (8 >> s)) != 0) {
+				child = { node.x + edgeDir[s][0], node.y + edgeDir[s][1], 0, TRUE, 0 };
+				return true;
+			}
+			if (s >= 4 && (spawnedgetable[node.tile] & (0x80 >> (s - 4))) != 0) {
+				child = { node.x + edgeDir[s - 4][0], node.y + edgeDir[s - 4][1], 0, FALSE, 0 };
+				return true;
+			}
+		} else if (node.tile != 8) {
+			if (s >= 4) {
+				return false;
+			}
+			if ((spawntable[node.tile] & (8 >> s)) != 0) {
+				child = { node.x + edgeDir[s][0], node.y + edgeDir[s][1], 0, TRUE, 0 };
+				return true;
+			}
+		} else {
+			if (s >= 4) {
+				return false;
+			}
+			child = { node.x + dirtDir[s][0], node.y + dirtDir[s][1], 0, FALSE, 0 };
+			return true;
+		}
 	}
+}
 
-	i = GetDungeon(x, y);
-	SetDungeon(x, y, GetDungeon(x, y) | 0x80);
-	*totarea += 1;
+/**
+ * @brief Mark the cells of the area around (x, y)
+ * @return TRUE if the area reaches the map edge or is bigger than 40 cells
+ */
+static BOOL DRLG_L3Spawn(int x, int y, int *totarea)
+{
+	L3SpawnNode root = { x, y, 0, FALSE, 0 };
+	auto enter = [totarea](L3SpawnNode &node) { return DRLG_L3SpawnEnter(node, totarea); };
 
-	if (i != 8) {
-		if (spawntable[i] & 8 && DRLG_L3SpawnEdge(x, y - 1, totarea) == TRUE) {
-			return TRUE;
-		}
-		if (spawntable[i] & 4 && DRLG_L3SpawnEdge(x, y + 1, totarea) == TRUE) {
-			return TRUE;
-		}
-		if (spawntable[i] & 2 && DRLG_L3SpawnEdge(x + 1, y, totarea) == TRUE) {
-			return TRUE;
-		}
-		if (spawntable[i] & 1 && DRLG_L3SpawnEdge(x - 1, y, totarea) == TRUE) {
-			return TRUE;
-		}
-	} else {
-		if (DRLG_L3Spawn(x + 1, y, totarea) == TRUE) {
-			return TRUE;
-		}
-		if (DRLG_L3Spawn(x - 1, y, totarea) == TRUE) {
-			return TRUE;
-		}
-		if (DRLG_L3Spawn(x, y + 1, totarea) == TRUE) {
-			return TRUE;
-		}
-		if (DRLG_L3Spawn(x, y - 1, totarea) == TRUE) {
-			return TRUE;
-		}
+	if (!OrderedFlood(root, enter, DRLG_L3SpawnNext)) {
+		return TRUE;
 	}
 
 	return FALSE;
@@ -1541,10 +1539,10 @@ static void DRLG_L3Pool()
 
 	for (duny = 0; duny < DMAXY; duny++) {
 		for (dunx = 0; dunx < DMAXY; dunx++) {
-			if (GetDungeon(dunx, duny) != 8) {
+			if (dungeon[dunx][duny] != 8) {
 				continue;
 			}
-			SetDungeon(dunx, duny, GetDungeon(dunx, duny) | 0x80);
+			dungeon[dunx][duny] = dungeon[dunx][duny] | 0x80;
 			totarea = 1;
 			if (dunx + 1 < DMAXX) {
 				found = DRLG_L3Spawn(dunx + 1, duny, &totarea);
@@ -1593,7 +1591,7 @@ static void DRLG_L3PoolFix()
 
 	for (duny = 0; duny < DMAXY; duny++) {     // BUGFIX: Change '0' to '1' and 'DMAXY' to 'DMAXY - 1'
 		for (dunx = 0; dunx < DMAXX; dunx++) { // BUGFIX: Change '0' to '1' and 'DMAXX' to 'DMAXX - 1'
-			if (GetDungeon(dunx, duny) == 8) {
+			if (dungeon[dunx][duny] == 8) {
 				if (GetDungeon(dunx - 1, duny - 1) >= 25 && GetDungeon(dunx - 1, duny - 1) <= 41
 				    && GetDungeon(dunx - 1, duny) >= 25 && GetDungeon(dunx - 1, duny) <= 41
 				    && GetDungeon(dunx - 1, duny + 1) >= 25 && GetDungeon(dunx - 1, duny + 1) <= 41
@@ -1602,7 +1600,7 @@ static void DRLG_L3PoolFix()
 				    && GetDungeon(dunx + 1, duny - 1) >= 25 && GetDungeon(dunx + 1, duny - 1) <= 41
 				    && GetDungeon(dunx + 1, duny) >= 25 && GetDungeon(dunx + 1, duny) <= 41
 				    && GetDungeon(dunx + 1, duny + 1) >= 25 && GetDungeon(dunx + 1, duny + 1) <= 41) {
-					SetDungeon(dunx, duny, 33);
+					dungeon[dunx][duny] = 33;
 				}
 			}
 		}
@@ -1611,8 +1609,9 @@ static void DRLG_L3PoolFix()
 
 static BOOL DRLG_L3PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx, int cy, BOOL setview, int ldir)
 {
-	int sx, sy, sw, sh, xx, yy, i, ii, numt, trys;
+	int sx, sy, sw, sh, xx, yy, i, ii, numt, trys, skip;
 	BOOL found;
+	MiniSetIndex index;
 
 	sw = miniset[0];
 	sh = miniset[1];
@@ -1623,12 +1622,28 @@ static BOOL DRLG_L3PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx,
 		numt = random_(0, tmax - tmin) + tmin;
 	}
 
+	index.Build(miniset, dungeon, (const BYTE(*)[DMAXY])dflags);
+	if (cx != -1) {
+		index.Stop(cx - sw, 0, cx + 12, DMAXY);
+	}
+	if (cy != -1) {
+		index.Stop(0, cy - sh, DMAXX, cy + 12);
+	}
+
 	for (i = 0; i < numt; i++) {
 		sx = random_(0, DMAXX - sw);
 		sy = random_(0, DMAXY - sh);
 		found = FALSE;
 		trys = 0;
 		while (!found && trys < 200) {
+			// Jump over the positions that would only be stepped over
+			skip = index.Distance(sx, sy, 200 - trys);
+			trys += skip;
+			if (trys >= 200) {
+				break;
+			}
+			index.Advance(sx, sy, skip);
+
 			trys++;
 			found = TRUE;
 			if (cx != -1 && sx >= cx - sw && sx <= cx + 12) {
@@ -1641,17 +1656,8 @@ static BOOL DRLG_L3PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx,
 				sy = random_(0, DMAXY - sh);
 				found = FALSE;
 			}
-			ii = 2;
-			for (yy = 0; yy < sh && found == TRUE; yy++) {
-				for (xx = 0; xx < sw && found == TRUE; xx++) {
-					if (miniset[ii] != 0 && GetDungeon(xx + sx, yy + sy) != miniset[ii]) {
-						found = FALSE;
-					}
-					if (dflags[xx + sx][yy + sy] != 0) {
-						found = FALSE;
-					}
-					ii++;
-				}
+			if (found == TRUE && !index.Matches(sx, sy)) {
+				found = FALSE;
 			}
 			if (!found) {
 				sx++;
@@ -1676,6 +1682,7 @@ static BOOL DRLG_L3PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx,
 				ii++;
 			}
 		}
+		index.Update(sx, sy);
 	}
 
 	if (setview == TRUE) {
@@ -1692,26 +1699,19 @@ static BOOL DRLG_L3PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx,
 
 static void DRLG_L3PlaceRndSet(const BYTE *miniset, int rndper)
 {
-	int sx, sy, sw, sh, xx, yy, ii, kk;
+	int sx, sy, sw, sh, xx, yy, kk;
 	BOOL found;
+	MiniSetIndex index;
 
 	sw = miniset[0];
 	sh = miniset[1];
+	index.Build(miniset, dungeon, (const BYTE(*)[DMAXY])dflags);
 
 	for (sy = 0; sy < DMAXX - sh; sy++) {
 		for (sx = 0; sx < DMAXY - sw; sx++) {
 			found = TRUE;
-			ii = 2;
-			for (yy = 0; yy < sh && found == TRUE; yy++) {
-				for (xx = 0; xx < sw && found == TRUE; xx++) {
-					if (miniset[ii] != 0 && GetDungeon(xx + sx, yy + sy) != miniset[ii]) {
-						found = FALSE;
-					}
-					if (dflags[xx + sx][yy + sy] != 0) {
-						found = FALSE;
-					}
-					ii++;
-				}
+			if (found == TRUE && !index.Matches(sx, sy)) {
+				found = FALSE;
 			}
 			kk = sw * sh + 2;
 			// BUGFIX: This should not be applied to Nest levels
@@ -1740,6 +1740,7 @@ static void DRLG_L3PlaceRndSet(const BYTE *miniset, int rndper)
 						kk++;
 					}
 				}
+				index.Update(sx, sy);
 			}
 		}
 	}
@@ -1748,28 +1749,21 @@ static void DRLG_L3PlaceRndSet(const BYTE *miniset, int rndper)
 #ifdef HELLFIRE
 BOOLEAN drlg_l3_hive_rnd_piece(const BYTE *miniset, int rndper)
 {
-	int sx, sy, sw, sh, xx, yy, ii, kk;
+	int sx, sy, sw, sh, xx, yy, kk;
 	BOOL found;
+	MiniSetIndex index;
 	BOOLEAN placed;
 
 	placed = FALSE;
 	sw = miniset[0];
 	sh = miniset[1];
+	index.Build(miniset, dungeon, (const BYTE(*)[DMAXY])dflags);
 
 	for (sy = 0; sy < DMAXX - sh; sy++) {
 		for (sx = 0; sx < DMAXY - sw; sx++) {
 			found = TRUE;
-			ii = 2;
-			for (yy = 0; yy < sh && found == TRUE; yy++) {
-				for (xx = 0; xx < sw && found == TRUE; xx++) {
-					if (miniset[ii] != 0 && GetDungeon(xx + sx, yy + sy) != miniset[ii]) {
-						found = FALSE;
-					}
-					if (dflags[xx + sx][yy + sy] != 0) {
-						found = FALSE;
-					}
-					ii++;
-				}
+			if (found == TRUE && !index.Matches(sx, sy)) {
+				found = FALSE;
 			}
 			kk = sw * sh + 2;
 			if (miniset[kk] >= 84 && miniset[kk] <= 100 && found == TRUE) {
@@ -1798,6 +1792,7 @@ BOOLEAN drlg_l3_hive_rnd_piece(const BYTE *miniset, int rndper)
 						kk++;
 					}
 				}
+				index.Update(sx, sy);
 			}
 		}
 	}
@@ -1932,14 +1927,14 @@ void FenceDoorFix()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 146) {
+			if (dungeon[i][j] == 146) {
 				if (GetDungeon(i + 1, j) > 152 || GetDungeon(i + 1, j) < 130
 				    || GetDungeon(i - 1, j) > 152 || GetDungeon(i - 1, j) < 130) {
-					SetDungeon(i, j, 7);
+					dungeon[i][j] = 7;
 					continue;
 				}
 			}
-			if (GetDungeon(i, j) == 146) {
+			if (dungeon[i][j] == 146) {
 				if (GetDungeon(i + 1, j) != 130 && GetDungeon(i - 1, j) != 130
 				    && GetDungeon(i + 1, j) != 132 && GetDungeon(i - 1, j) != 132
 				    && GetDungeon(i + 1, j) != 133 && GetDungeon(i - 1, j) != 133
@@ -1947,18 +1942,18 @@ void FenceDoorFix()
 				    && GetDungeon(i + 1, j) != 136 && GetDungeon(i - 1, j) != 136
 				    && GetDungeon(i + 1, j) != 138 && GetDungeon(i - 1, j) != 138
 				    && GetDungeon(i + 1, j) != 140 && GetDungeon(i - 1, j) != 140) {
-					SetDungeon(i, j, 7);
+					dungeon[i][j] = 7;
 					continue;
 				}
 			}
-			if (GetDungeon(i, j) == 147) {
+			if (dungeon[i][j] == 147) {
 				if (GetDungeon(i, j + 1) > 152 || GetDungeon(i, j + 1) < 130
 				    || GetDungeon(i, j - 1) > 152 || GetDungeon(i, j - 1) < 130) {
-					SetDungeon(i, j, 7);
+					dungeon[i][j] = 7;
 					continue;
 				}
 			}
-			if (GetDungeon(i, j) == 147) {
+			if (dungeon[i][j] == 147) {
 				if (GetDungeon(i, j + 1) != 131 && GetDungeon(i, j - 1) != 131
 				    && GetDungeon(i, j + 1) != 132 && GetDungeon(i, j - 1) != 132
 				    && GetDungeon(i, j + 1) != 133 && GetDungeon(i, j - 1) != 133
@@ -1966,7 +1961,7 @@ void FenceDoorFix()
 				    && GetDungeon(i, j + 1) != 137 && GetDungeon(i, j - 1) != 137
 				    && GetDungeon(i, j + 1) != 138 && GetDungeon(i, j - 1) != 138
 				    && GetDungeon(i, j + 1) != 139 && GetDungeon(i, j - 1) != 139) {
-					SetDungeon(i, j, 7);
+					dungeon[i][j] = 7;
 					continue;
 				}
 			}
@@ -1981,14 +1976,14 @@ static void DRLG_L3Wood()
 
 	for (j = 0; j < DMAXY - 1; j++) {     // BUGFIX: Change '0' to '1'
 		for (i = 0; i < DMAXX - 1; i++) { // BUGFIX: Change '0' to '1'
-			if (GetDungeon(i, j) == 10 && random_(0, 2) != 0) {
+			if (dungeon[i][j] == 10 && random_(0, 2) != 0) {
 				x = i;
 				while (GetDungeon(x, j) == 10) {
 					x++;
 				}
 				x--;
 				if (x - i > 0) {
-					SetDungeon(i, j, 127);
+					dungeon[i][j] = 127;
 					for (xx = i + 1; xx < x; xx++) {
 						if (random_(0, 2) != 0) {
 							SetDungeon(xx, j, 126);
@@ -1999,14 +1994,14 @@ static void DRLG_L3Wood()
 					SetDungeon(x, j, 128);
 				}
 			}
-			if (GetDungeon(i, j) == 9 && random_(0, 2) != 0) {
+			if (dungeon[i][j] == 9 && random_(0, 2) != 0) {
 				y = j;
 				while (GetDungeon(i, y) == 9) {
 					y++;
 				}
 				y--;
 				if (y - j > 0) {
-					SetDungeon(i, j, 123);
+					dungeon[i][j] = 123;
 					for (yy = j + 1; yy < y; yy++) {
 						if (random_(0, 2) != 0) {
 							SetDungeon(i, yy, 121);
@@ -2017,8 +2012,8 @@ static void DRLG_L3Wood()
 					SetDungeon(i, y, 122);
 				}
 			}
-			if (GetDungeon(i, j) == 11 && GetDungeon(i + 1, j) == 10 && GetDungeon(i, j + 1) == 9 && random_(0, 2) != 0) {
-				SetDungeon(i, j, 125);
+			if (dungeon[i][j] == 11 && dungeon[i + 1][j] == 10 && dungeon[i][j + 1] == 9 && random_(0, 2) != 0) {
+				dungeon[i][j] = 125;
 				x = i + 1;
 				while (GetDungeon(x, j) == 10) {
 					x++;
@@ -2051,7 +2046,7 @@ static void DRLG_L3Wood()
 
 	for (j = 0; j < DMAXY; j++) {     // BUGFIX: Change '0' to '1'
 		for (i = 0; i < DMAXX; i++) { // BUGFIX: Change '0' to '1'
-			if (GetDungeon(i, j) == 7 && random_(0, 1) == 0 && SkipThemeRoom(i, j)) {
+			if (dungeon[i][j] == 7 && random_(0, 1) == 0 && SkipThemeRoom(i, j)) {
 				rt = random_(0, 2);
 				if (rt == 0) {
 					y1 = j;
@@ -2277,20 +2272,6 @@ void FixL3HallofHeroes()
 	}
 }
 
-void DRLG_L3LockRec(int x, int y)
-{
-	if (!lockout[x][y]) {
-		return;
-	}
-
-	lockout[x][y] = FALSE;
-	lockoutcnt++;
-	DRLG_L3LockRec(x, y - 1);
-	DRLG_L3LockRec(x, y + 1);
-	DRLG_L3LockRec(x - 1, y);
-	DRLG_L3LockRec(x + 1, y);
-}
-
 BOOL DRLG_L3Lockout()
 {
 	int i, j, t, fx, fy;
@@ -2298,7 +2279,7 @@ BOOL DRLG_L3Lockout()
 	t = 0;
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) != 0) {
+			if (dungeon[i][j] != 0) {
 				lockout[i][j] = TRUE;
 				fx = i;
 				fy = j;
@@ -2309,8 +2290,7 @@ BOOL DRLG_L3Lockout()
 		}
 	}
 
-	lockoutcnt = 0;
-	DRLG_L3LockRec(fx, fy);
+	lockoutcnt = FloodClear(&lockout[0][0], DMAXX * DMAXY, DMAXY, fx * DMAXY + fy);
 
 	return t == lockoutcnt;
 }
@@ -2622,101 +2602,7 @@ static std::optional<uint32_t> DRLG_L3(int entry, DungeonMode mode)
 
 static void DRLG_L3Pass3()
 {
-	int i, j, xx, yy;
-	long v1, v2, v3, v4, lv;
-
-	lv = 8 - 1;
-
-#ifdef USE_ASM
-	__asm {
-		mov		esi, pMegaTiles
-		mov		eax, lv
-		shl		eax, 3
-		add		esi, eax
-		xor		eax, eax
-		lodsw
-		inc		eax
-		mov		v1, eax
-		lodsw
-		inc		eax
-		mov		v2, eax
-		lodsw
-		inc		eax
-		mov		v3, eax
-		lodsw
-		inc		eax
-		mov		v4, eax
-	}
-#else
-	v1 = *((WORD *)&pMegaTiles[lv * 8] + 0) + 1;
-	v2 = *((WORD *)&pMegaTiles[lv * 8] + 1) + 1;
-	v3 = *((WORD *)&pMegaTiles[lv * 8] + 2) + 1;
-	v4 = *((WORD *)&pMegaTiles[lv * 8] + 3) + 1;
-#endif
-
-	for (j = 0; j < MAXDUNY; j += 2)
-	{
-		for (i = 0; i < MAXDUNX; i += 2) {
-			dPiece[i][j] = v1;
-			dPiece[i + 1][j] = v2;
-			dPiece[i][j + 1] = v3;
-			dPiece[i + 1][j + 1] = v4;
-		}
-	}
-
-	yy = 16;
-	for (j = 0; j < DMAXY; j++) {
-		xx = 16;
-		for (i = 0; i < DMAXX; i++) {
-			lv = GetDungeon(i, j) - 1;
-#ifdef USE_ASM
-			if (lv >= 0) {
-				__asm {
-					mov		esi, pMegaTiles
-					mov		eax, lv
-					shl		eax, 3
-					add		esi, eax
-					xor		eax, eax
-					lodsw
-					inc		eax
-					mov		v1, eax
-					lodsw
-					inc		eax
-					mov		v2, eax
-					lodsw
-					inc		eax
-					mov		v3, eax
-					lodsw
-					inc		eax
-					mov		v4, eax
-				}
-			} else {
-				v1 = 0;
-				v2 = 0;
-				v3 = 0;
-				v4 = 0;
-			}
-#else
-			if (lv >= 0) {
-				v1 = *((WORD *)&pMegaTiles[lv * 8] + 0) + 1;
-				v2 = *((WORD *)&pMegaTiles[lv * 8] + 1) + 1;
-				v3 = *((WORD *)&pMegaTiles[lv * 8] + 2) + 1;
-				v4 = *((WORD *)&pMegaTiles[lv * 8] + 3) + 1;
-			} else {
-				v1 = 0;
-				v2 = 0;
-				v3 = 0;
-				v4 = 0;
-			}
-#endif
-			dPiece[xx][yy] = v1;
-			dPiece[xx + 1][yy] = v2;
-			dPiece[xx][yy + 1] = v3;
-			dPiece[xx + 1][yy + 1] = v4;
-			xx += 2;
-		}
-		yy += 2;
-	}
+	DRLG_ExpandMegaTiles(8);
 }
 
 std::optional<uint32_t> CreateL3Dungeon(DWORD rseed, int entry, DungeonMode mode)
@@ -2766,7 +2652,7 @@ void LoadL3Dungeon(const char *sFileName, int vx, int vy)
 	dmaxx = 96;
 	dmaxy = 96;
 	DRLG_InitTrans();
-	pLevelMap = LoadFileInMem(sFileName, NULL);
+	pLevelMap = LoadLevelFileInMem(sFileName, NULL);
 
 	lm = pLevelMap;
 	rw = *lm;
@@ -2786,8 +2672,8 @@ void LoadL3Dungeon(const char *sFileName, int vx, int vy)
 	}
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 0) {
-				SetDungeon(i, j, 8);
+			if (dungeon[i][j] == 0) {
+				dungeon[i][j] = 8;
 			}
 		}
 	}
@@ -2824,7 +2710,7 @@ void LoadPreL3Dungeon(const char *sFileName, int vx, int vy)
 
 	InitL3Dungeon();
 	DRLG_InitTrans();
-	pLevelMap = LoadFileInMem(sFileName, NULL);
+	pLevelMap = LoadLevelFileInMem(sFileName, NULL);
 
 	lm = pLevelMap;
 	rw = *lm;
@@ -2844,8 +2730,8 @@ void LoadPreL3Dungeon(const char *sFileName, int vx, int vy)
 	}
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 0) {
-				SetDungeon(i, j, 8);
+			if (dungeon[i][j] == 0) {
+				dungeon[i][j] = 8;
 			}
 		}
 	}
@@ -5,6 +5,9 @@
  */
 #include "all.h"
 
+#include "mapGen/miniSetIndex.h"
+#include "mapGen/tileRules.h"
+
 int diabquad1x;
 int diabquad1y;
 int diabquad2x;
@@ -142,63 +145,40 @@ const BYTE L4BTYPES[140] = {
 
 static BYTE GetDung(int x, int y)
 {
-	if (x < 0 || y < 0 || x >= 20 || y >= 20) {
-		int index = x * 20 + y;
-		x = index / 20;
-		y = index % 20;
-		if (x < 0 || y < 0 || x >= 20) {
-			oobread = true;
-			return 0;
-		}
+	unsigned index = x * 20 + y;
+	if (index >= 20 * 20) {
+		oobread = true;
+		return 0;
 	}
-	return dung[x][y];
+	return dung[index / 20][index % 20];
 }
 
 static void SetDung(int x, int y, int value)
 {
-	if (x < 0 || y < 0 || x >= 20 || y >= 20) {
-		int index = x * 20 + y;
-		x = index / 20;
-		y = index % 20;
-		if (x < 0 || y < 0 || x >= 20) {
-			oobwrite = true;
-			return;
-		}
+	unsigned index = x * 20 + y;
+	if (index >= 20 * 20) {
+		oobwrite = true;
+		return;
 	}
-	dung[x][y] = value;
+	dung[index / 20][index % 20] = value;
 }
 
+/* centre, { checked neighbours }, replaced neighbour, the positions are (dx, dy) from the centre */
+constexpr TileRule L4ShadowRules[] = {
+	{ 3, { { -1, 0, 6 } }, { -1, 0, 47 } },
+	{ 3, { { -1, -1, 6 } }, { -1, -1, 48 } },
+	{ 4, { { -1, 0, 6 } }, { -1, 0, 47 } },
+	{ 4, { { -1, -1, 6 } }, { -1, -1, 48 } },
+	{ 8, { { -1, 0, 6 } }, { -1, 0, 47 } },
+	{ 8, { { -1, -1, 6 } }, { -1, -1, 48 } },
+	{ 15, { { -1, 0, 6 } }, { -1, 0, 47 } },
+	{ 15, { { -1, -1, 6 } }, { -1, -1, 48 } },
+};
+constexpr auto L4Shadows = CompileTileRules(L4ShadowRules);
+
 static void DRLG_L4Shadows()
 {
-	int x, y;
-	BOOL okflag;
-
-	for (y = 1; y < DMAXY; y++) {
-		for (x = 1; x < DMAXY; x++) {
-			okflag = FALSE;
-			if (GetDungeon(x, y) == 3) {
-				okflag = TRUE;
-			}
-			if (GetDungeon(x, y) == 4) {
-				okflag = TRUE;
-			}
-			if (GetDungeon(x, y) == 8) {
-				okflag = TRUE;
-			}
-			if (GetDungeon(x, y) == 15) {
-				okflag = TRUE;
-			}
-			if (!okflag) {
-				continue;
-			}
-			if (GetDungeon(x - 1, y) == 6) {
-				SetDungeon(x - 1, y, 47);
-			}
-			if (GetDungeon(x - 1, y - 1) == 6) {
-				SetDungeon(x - 1, y - 1, 48);
-			}
-		}
-	}
+	ApplyTileRules(L4Shadows, dungeon, TileAccess::Unchecked, 1, 1);
 }
 
 static void InitL4Dungeon()
@@ -210,7 +190,7 @@ static void InitL4Dungeon()
 
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
-			SetDungeon(i, j, 30);
+			dungeon[i][j] = 30;
 			dflags[i][j] = 0;
 		}
 	}
@@ -220,11 +200,11 @@ void DRLG_LoadL4SP()
 {
 	setloadflag = FALSE;
 	if (QuestStatus(Q_WARLORD)) {
-		pSetPiece = LoadFileInMem("Levels\\L4Data\\Warlord.DUN", NULL);
+		pSetPiece = LoadLevelFileInMem("Levels\\L4Data\\Warlord.DUN", NULL);
 		setloadflag = TRUE;
 	}
 	if (currlevel == 15 && gbMaxPlayers != 1) {
-		pSetPiece = LoadFileInMem("Levels\\L4Data\\Vile1.DUN", NULL);
+		pSetPiece = LoadLevelFileInMem("Levels\\L4Data\\Vile1.DUN", NULL);
 		setloadflag = TRUE;
 	}
 }
@@ -483,91 +463,91 @@ static void L4AddWall()
 			if (dflags[i][j] != 0) {
 				continue;
 			}
-			if (GetDungeon(i, j) == 10 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 10 && random_(0, 100) < 100) {
 				x = L4HWallOk(i, j);
 				if (x != -1) {
 					L4HorizWall(i, j, x);
 				}
 			}
-			if (GetDungeon(i, j) == 12 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 12 && random_(0, 100) < 100) {
 				x = L4HWallOk(i, j);
 				if (x != -1) {
 					L4HorizWall(i, j, x);
 				}
 			}
-			if (GetDungeon(i, j) == 13 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 13 && random_(0, 100) < 100) {
 				x = L4HWallOk(i, j);
 				if (x != -1) {
 					L4HorizWall(i, j, x);
 				}
 			}
-			if (GetDungeon(i, j) == 15 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 15 && random_(0, 100) < 100) {
 				x = L4HWallOk(i, j);
 				if (x != -1) {
 					L4HorizWall(i, j, x);
 				}
 			}
-			if (GetDungeon(i, j) == 16 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 16 && random_(0, 100) < 100) {
 				x = L4HWallOk(i, j);
 				if (x != -1) {
 					L4HorizWall(i, j, x);
 				}
 			}
-			if (GetDungeon(i, j) == 21 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 21 && random_(0, 100) < 100) {
 				x = L4HWallOk(i, j);
 				if (x != -1) {
 					L4HorizWall(i, j, x);
 				}
 			}
-			if (GetDungeon(i, j) == 22 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 22 && random_(0, 100) < 100) {
 				x = L4HWallOk(i, j);
 				if (x != -1) {
 					L4HorizWall(i, j, x);
 				}
 			}
-			if (GetDungeon(i, j) == 8 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 8 && random_(0, 100) < 100) {
 				y = L4VWallOk(i, j);
 				if (y != -1) {
 					L4VertWall(i, j, y);
 				}
 			}
-			if (GetDungeon(i, j) == 9 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 9 && random_(0, 100) < 100) {
 				y = L4VWallOk(i, j);
 				if (y != -1) {
 					L4VertWall(i, j, y);
 				}
 			}
-			if (GetDungeon(i, j) == 11 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 11 && random_(0, 100) < 100) {
 				y = L4VWallOk(i, j);
 				if (y != -1) {
 					L4VertWall(i, j, y);
 				}
 			}
-			if (GetDungeon(i, j) == 14 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 14 && random_(0, 100) < 100) {
 				y = L4VWallOk(i, j);
 				if (y != -1) {
 					L4VertWall(i, j, y);
 				}
 			}
-			if (GetDungeon(i, j) == 15 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 15 && random_(0, 100) < 100) {
 				y = L4VWallOk(i, j);
 				if (y != -1) {
 					L4VertWall(i, j, y);
 				}
 			}
-			if (GetDungeon(i, j) == 16 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 16 && random_(0, 100) < 100) {
 				y = L4VWallOk(i, j);
 				if (y != -1) {
 					L4VertWall(i, j, y);
 				}
 			}
-			if (GetDungeon(i, j) == 21 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 21 && random_(0, 100) < 100) {
 				y = L4VWallOk(i, j);
 				if (y != -1) {
 					L4VertWall(i, j, y);
 				}
 			}
-			if (GetDungeon(i, j) == 23 && random_(0, 100) < 100) {
+			if (dungeon[i][j] == 23 && random_(0, 100) < 100) {
 				y = L4VWallOk(i, j);
 				if (y != -1) {
 					L4VertWall(i, j, y);
@@ -577,350 +557,198 @@ static void L4AddWall()
 	}
 }
 
+/* centre, { checked neighbours }, replaced neighbour, the positions are (dx, dy) from the centre */
+constexpr TileRule L4TileFixRules1[] = {
+	{ 2, { { 1, 0, 6 } }, { 1, 0, 5 } },
+	{ 2, { { 1, 0, 1 } }, { 1, 0, 13 } },
+	{ 1, { { 0, 1, 2 } }, { 0, 1, 14 } },
+};
+constexpr auto L4TileFix1 = CompileTileRules(L4TileFixRules1);
+
+constexpr TileRule L4TileFixRules2[] = {
+	{ 2, { { 1, 0, 6 } }, { 1, 0, 2 } },
+	{ 2, { { 1, 0, 9 } }, { 1, 0, 11 } },
+	{ 9, { { 1, 0, 6 } }, { 1, 0, 12 } },
+	{ 14, { { 1, 0, 1 } }, { 1, 0, 13 } },
+	{ 6, { { 1, 0, 14 } }, { 1, 0, 15 } },
+	{ 6, { { 0, 1, 13 } }, { 0, 1, 16 } },
+	{ 1, { { 0, 1, 9 } }, { 0, 1, 10 } },
+	{ 6, { { 0, -1, 1 } }, { 0, -1, 1 } },
+};
+constexpr auto L4TileFix2 = CompileTileRules(L4TileFixRules2);
+
+constexpr TileRule L4TileFixRules3[] = {
+	{ 13, { { 0, 1, 30 } }, { 0, 1, 27 } },
+	{ 27, { { 1, 0, 30 } }, { 1, 0, 19 } },
+	{ 1, { { 0, 1, 30 } }, { 0, 1, 27 } },
+	{ 27, { { 1, 0, 1 } }, { 1, 0, 16 } },
+	{ 19, { { 1, 0, 27 } }, { 1, 0, 26 } },
+	{ 27, { { 1, 0, 30 } }, { 1, 0, 19 } },
+	{ 2, { { 1, 0, 15 } }, { 1, 0, 14 } },
+	{ 14, { { 1, 0, 15 } }, { 1, 0, 14 } },
+	{ 22, { { 1, 0, 1 } }, { 1, 0, 16 } },
+	{ 27, { { 1, 0, 1 } }, { 1, 0, 16 } },
+	{ 6, { { 1, 0, 27 }, { 1, 1, 0, true } }, { 1, 0, 22 } }, /* check */
+	{ 22, { { 1, 0, 30 } }, { 1, 0, 19 } },
+	{ 21, { { 1, 0, 1 }, { 1, -1, 1 } }, { 1, 0, 13 } },
+	{ 14, { { 1, 0, 30 }, { 0, 1, 6 } }, { 1, 0, 28 } },
+	{ 16, { { 1, 0, 6 }, { 0, 1, 30 } }, { 0, 1, 27 } },
+	{ 16, { { 0, 1, 30 }, { 1, 1, 30 } }, { 0, 1, 27 } },
+	{ 6, { { 1, 0, 30 }, { 1, -1, 6 } }, { 1, 0, 21 } },
+	{ 2, { { 1, 0, 27 }, { 1, 1, 9 } }, { 1, 0, 29 } },
+	{ 9, { { 1, 0, 15 } }, { 1, 0, 14 } },
+	{ 15, { { 1, 0, 27 }, { 1, 1, 2 } }, { 1, 0, 29 } },
+	{ 19, { { 1, 0, 18 } }, { 1, 0, 24 } },
+	{ 9, { { 1, 0, 15 } }, { 1, 0, 14 } },
+	{ 19, { { 1, 0, 19 }, { 1, -1, 30 } }, { 1, 0, 24 } },
+	{ 24, { { 0, -1, 30 }, { 0, -2, 6 } }, { 0, -1, 21 } },
+	{ 2, { { 1, 0, 30 } }, { 1, 0, 28 } },
+	{ 15, { { 1, 0, 30 } }, { 1, 0, 28 } },
+	{ 28, { { 0, 1, 30 } }, { 0, 1, 18 } },
+	{ 28, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 19, { { 2, 0, 2 }, { 1, -1, 18 }, { 1, 1, 1 } }, { 1, 0, 17 } },
+	{ 19, { { 2, 0, 2 }, { 1, -1, 22 }, { 1, 1, 1 } }, { 1, 0, 17 } },
+	{ 19, { { 2, 0, 2 }, { 1, -1, 18 }, { 1, 1, 13 } }, { 1, 0, 17 } },
+	{ 21, { { 2, 0, 2 }, { 1, -1, 18 }, { 1, 1, 1 } }, { 1, 0, 17 } },
+	{ 21, { { 1, 1, 1 }, { 1, -1, 22 }, { 2, 0, 3 } }, { 1, 0, 17 } },
+	{ 15, { { 1, 0, 28 }, { 2, 0, 30 }, { 1, -1, 6 } }, { 1, 0, 23 } },
+	{ 14, { { 1, 0, 28 }, { 2, 0, 1 } }, { 1, 0, 23 } },
+	{ 15, { { 1, 0, 27 }, { 1, 1, 30 } }, { 1, 0, 29 } },
+	{ 28, { { 0, 1, 9 } }, { 0, 1, 15 } },
+	{ 21, { { 1, -1, 21 } }, { 1, 0, 24 } },
+	{ 2, { { 1, 0, 27 }, { 1, 1, 30 } }, { 1, 0, 29 } },
+	{ 2, { { 1, 0, 18 } }, { 1, 0, 25 } },
+	{ 21, { { 1, 0, 9 }, { 2, 0, 2 } }, { 1, 0, 11 } },
+	{ 19, { { 1, 0, 10 } }, { 1, 0, 17 } },
+	{ 15, { { 0, 1, 3 } }, { 0, 1, 4 } },
+	{ 22, { { 0, 1, 9 } }, { 0, 1, 15 } },
+	{ 18, { { 0, 1, 30 } }, { 0, 1, 18 } },
+	{ 24, { { -1, 0, 30 } }, { -1, 0, 19 } },
+	{ 21, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 21, { { 0, 1, 9 } }, { 0, 1, 10 } },
+	{ 22, { { 0, 1, 30 } }, { 0, 1, 18 } },
+	{ 21, { { 0, 1, 30 } }, { 0, 1, 18 } },
+	{ 16, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 13, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 22, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 21, { { 1, 0, 18 }, { 2, 0, 30 } }, { 1, 0, 24 } },
+	{ 21, { { 1, 0, 9 }, { 1, 1, 1 } }, { 1, 0, 16 } },
+	{ 2, { { 1, 0, 27 }, { 1, 1, 2 } }, { 1, 0, 29 } },
+	{ 23, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 23, { { 0, 1, 9 } }, { 0, 1, 15 } },
+	{ 25, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 22, { { 1, 0, 9 } }, { 1, 0, 11 } },
+	{ 23, { { 1, 0, 9 } }, { 1, 0, 11 } },
+	{ 15, { { 1, 0, 1 } }, { 1, 0, 16 } },
+	{ 11, { { 1, 0, 15 } }, { 1, 0, 14 } },
+	{ 23, { { 1, 0, 1 } }, { 1, 0, 16 } },
+	{ 21, { { 1, 0, 27 } }, { 1, 0, 26 } },
+	{ 21, { { 1, 0, 18 } }, { 1, 0, 24 } },
+	{ 26, { { 1, 0, 1 } }, { 1, 0, 16 } },
+	{ 29, { { 1, 0, 1 } }, { 1, 0, 16 } },
+	{ 29, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 1, { { 0, -1, 15 } }, { 0, -1, 10 } },
+	{ 18, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 23, { { 0, 1, 30 } }, { 0, 1, 18 } },
+	{ 18, { { 0, 1, 9 } }, { 0, 1, 10 } },
+	{ 14, { { 1, 0, 30 }, { 1, 1, 30 } }, { 1, 0, 23 } },
+	{ 2, { { 1, 0, 28 }, { 1, -1, 6 } }, { 1, 0, 23 } },
+	{ 23, { { 1, 0, 18 }, { 0, -1, 6 } }, { 1, 0, 24 } },
+	{ 14, { { 1, 0, 23 }, { 2, 0, 30 } }, { 1, 0, 28 } },
+	{ 14, { { 1, 0, 28 }, { 2, 0, 30 }, { 1, -1, 6 } }, { 1, 0, 23 } },
+	{ 23, { { 1, 0, 30 } }, { 1, 0, 19 } },
+	{ 29, { { 1, 0, 30 } }, { 1, 0, 19 } },
+	{ 29, { { 0, 1, 30 } }, { 0, 1, 18 } },
+	{ 19, { { 1, 0, 30 } }, { 1, 0, 19 } },
+	{ 21, { { 1, 0, 30 } }, { 1, 0, 19 } },
+	{ 26, { { 1, 0, 30 } }, { 1, 0, 19 } },
+	{ 16, { { 0, 1, 30 } }, { 0, 1, 18 } },
+	{ 13, { { 0, 1, 9 } }, { 0, 1, 10 } },
+	{ 25, { { 0, 1, 30 } }, { 0, 1, 18 } },
+	{ 18, { { 0, 1, 2 } }, { 0, 1, 15 } },
+	{ 11, { { 1, 0, 3 } }, { 1, 0, 5 } },
+	{ 19, { { 1, 0, 9 } }, { 1, 0, 11 } },
+	{ 19, { { 1, 0, 1 } }, { 1, 0, 13 } },
+	{ 19, { { 1, 0, 13 }, { 1, -1, 6 } }, { 1, 0, 16 } },
+};
+constexpr auto L4TileFix3 = CompileTileRules(L4TileFixRules3);
+
+constexpr TileRule L4TileFixRules4[] = {
+	{ 21, { { 0, 1, 24 }, { 0, 2, 1 } }, { 0, 1, 17 } },
+	{ 15, { { 1, 1, 9 }, { 1, -1, 1 }, { 2, 0, 16 } }, { 1, 0, 29 } },
+	{ 2, { { -1, 0, 6 } }, { -1, 0, 8 } },
+	{ 1, { { 0, -1, 6 } }, { 0, -1, 7 } },
+	{ 6, { { 1, 0, 15 }, { 1, 1, 4 } }, { 1, 0, 10 } },
+	{ 1, { { 0, 1, 3 } }, { 0, 1, 4 } },
+	{ 1, { { 0, 1, 6 } }, { 0, 1, 4 } },
+	{ 9, { { 0, 1, 3 } }, { 0, 1, 4 } },
+	{ 10, { { 0, 1, 3 } }, { 0, 1, 4 } },
+	{ 13, { { 0, 1, 3 } }, { 0, 1, 4 } },
+	{ 1, { { 0, 1, 5 } }, { 0, 1, 12 } },
+	{ 1, { { 0, 1, 16 } }, { 0, 1, 13 } },
+	{ 6, { { 0, 1, 13 } }, { 0, 1, 16 } },
+	{ 25, { { 0, 1, 9 } }, { 0, 1, 10 } },
+	{ 13, { { 0, 1, 5 } }, { 0, 1, 12 } },
+	{ 28, { { 0, -1, 6 }, { 1, 0, 1 } }, { 1, 0, 23 } },
+	{ 19, { { 1, 0, 10 } }, { 1, 0, 17 } },
+	{ 21, { { 1, 0, 9 } }, { 1, 0, 11 } },
+	{ 11, { { 1, 0, 3 } }, { 1, 0, 5 } },
+	{ 10, { { 1, 0, 4 } }, { 1, 0, 12 } },
+	{ 14, { { 1, 0, 4 } }, { 1, 0, 12 } },
+	{ 27, { { 1, 0, 9 } }, { 1, 0, 11 } },
+	{ 15, { { 1, 0, 4 } }, { 1, 0, 12 } },
+	{ 21, { { 1, 0, 1 } }, { 1, 0, 16 } },
+	{ 11, { { 1, 0, 4 } }, { 1, 0, 12 } },
+	{ 2, { { 1, 0, 3 } }, { 1, 0, 5 } },
+	{ 9, { { 1, 0, 3 } }, { 1, 0, 5 } },
+	{ 14, { { 1, 0, 3 } }, { 1, 0, 5 } },
+	{ 15, { { 1, 0, 3 } }, { 1, 0, 5 } },
+	{ 2, { { 1, 0, 5 }, { 1, -1, 16 } }, { 1, 0, 12 } },
+	{ 2, { { 1, 0, 4 } }, { 1, 0, 12 } },
+	{ 9, { { 1, 0, 4 } }, { 1, 0, 12 } },
+	{ 1, { { 0, -1, 8 } }, { 0, -1, 9 } },
+	{ 28, { { 1, 0, 23 }, { 1, 1, 3 } }, { 1, 0, 16 } },
+};
+constexpr auto L4TileFix4 = CompileTileRules(L4TileFixRules4);
+
+constexpr TileRule L4TileFixRules5[] = {
+	{ 21, { { 1, 0, 10 } }, { 1, 0, 17 } },
+	{ 17, { { 1, 0, 4 } }, { 1, 0, 12 } },
+	{ 10, { { 1, 0, 4 } }, { 1, 0, 12 } },
+	{ 17, { { 0, 1, 5 } }, { 0, 1, 12 } },
+	{ 29, { { 0, 1, 9 } }, { 0, 1, 10 } },
+	{ 13, { { 0, 1, 5 } }, { 0, 1, 12 } },
+	{ 9, { { 0, 1, 16 } }, { 0, 1, 13 } },
+	{ 10, { { 0, 1, 16 } }, { 0, 1, 13 } },
+	{ 16, { { 0, 1, 3 } }, { 0, 1, 4 } },
+	{ 11, { { 0, 1, 5 } }, { 0, 1, 12 } },
+	{ 10, { { 1, 0, 3 }, { 1, -1, 16 } }, { 1, 0, 12 } },
+	{ 16, { { 0, 1, 5 } }, { 0, 1, 12 } },
+	{ 1, { { 0, 1, 6 } }, { 0, 1, 4 } },
+	{ 21, { { 1, 0, 13 }, { 0, 1, 10 } }, { 1, 1, 12 } },
+	{ 15, { { 1, 0, 10 } }, { 1, 0, 17 } },
+	{ 22, { { 0, 1, 11 } }, { 0, 1, 17 } },
+	{ 15, { { 1, 0, 28 }, { 2, 0, 16 } }, { 1, 0, 23 } },
+	{ 28, { { 1, 0, 23 }, { 1, 1, 1 }, { 2, 0, 6 } }, { 1, 0, 16 } },
+};
+constexpr auto L4TileFix5 = CompileTileRules(L4TileFixRules5);
+
+constexpr TileRule L4TileFixRules6[] = {
+	{ 15, { { 1, 0, 28 }, { 2, 0, 16 } }, { 1, 0, 23 } },
+	{ 21, { { 1, -1, 21 }, { 1, 1, 13 }, { 2, 0, 2 } }, { 1, 0, 17 } },
+	{ 19, { { 1, 0, 15 }, { 1, 1, 12 } }, { 1, 0, 17 } },
+};
+constexpr auto L4TileFix6 = CompileTileRules(L4TileFixRules6);
+
 static void L4tileFix()
 {
-	int i, j;
-
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 6)
-				dungeon[i + 1][j] = 5;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 13;
-			if (dungeon[i][j] == 1 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 14;
-		}
-	}
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 6)
-				dungeon[i + 1][j] = 2;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 9)
-				dungeon[i + 1][j] = 11;
-			if (dungeon[i][j] == 9 && dungeon[i + 1][j] == 6)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 13;
-			if (dungeon[i][j] == 6 && dungeon[i + 1][j] == 14)
-				dungeon[i + 1][j] = 15;
-			if (dungeon[i][j] == 6 && dungeon[i][j + 1] == 13)
-				dungeon[i][j + 1] = 16;
-			if (dungeon[i][j] == 1 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 10;
-			if (dungeon[i][j] == 6 && dungeon[i][j - 1] == 1)
-				dungeon[i][j - 1] = 1;
-		}
-	}
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (dungeon[i][j] == 13 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 27;
-			if (dungeon[i][j] == 27 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 19;
-			if (dungeon[i][j] == 1 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 27;
-			if (dungeon[i][j] == 27 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 27)
-				dungeon[i + 1][j] = 26;
-			if (dungeon[i][j] == 27 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 19;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 15)
-				dungeon[i + 1][j] = 14;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 15)
-				dungeon[i + 1][j] = 14;
-			if (dungeon[i][j] == 22 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 27 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 6 && dungeon[i + 1][j] == 27 && dungeon[i + 1][j + 1] != 0) /* check */
-				dungeon[i + 1][j] = 22;
-			if (dungeon[i][j] == 22 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 19;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 1 && dungeon[i + 1][j - 1] == 1)
-				dungeon[i + 1][j] = 13;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 30 && dungeon[i][j + 1] == 6)
-				dungeon[i + 1][j] = 28;
-			if (dungeon[i][j] == 16 && dungeon[i + 1][j] == 6 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 27;
-			if (dungeon[i][j] == 16 && dungeon[i][j + 1] == 30 && dungeon[i + 1][j + 1] == 30)
-				dungeon[i][j + 1] = 27;
-			if (dungeon[i][j] == 6 && dungeon[i + 1][j] == 30 && dungeon[i + 1][j - 1] == 6)
-				dungeon[i + 1][j] = 21;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 27 && dungeon[i + 1][j + 1] == 9)
-				dungeon[i + 1][j] = 29;
-			if (dungeon[i][j] == 9 && dungeon[i + 1][j] == 15)
-				dungeon[i + 1][j] = 14;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 27 && dungeon[i + 1][j + 1] == 2)
-				dungeon[i + 1][j] = 29;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 18)
-				dungeon[i + 1][j] = 24;
-			if (dungeon[i][j] == 9 && dungeon[i + 1][j] == 15)
-				dungeon[i + 1][j] = 14;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 19 && dungeon[i + 1][j - 1] == 30)
-				dungeon[i + 1][j] = 24;
-			if (dungeon[i][j] == 24 && dungeon[i][j - 1] == 30 && dungeon[i][j - 2] == 6)
-				dungeon[i][j - 1] = 21;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 28;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 28;
-			if (dungeon[i][j] == 28 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 18;
-			if (dungeon[i][j] == 28 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 19 && dungeon[i + 2][j] == 2 && dungeon[i + 1][j - 1] == 18 && dungeon[i + 1][j + 1] == 1)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 19 && dungeon[i + 2][j] == 2 && dungeon[i + 1][j - 1] == 22 && dungeon[i + 1][j + 1] == 1)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 19 && dungeon[i + 2][j] == 2 && dungeon[i + 1][j - 1] == 18 && dungeon[i + 1][j + 1] == 13)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 21 && dungeon[i + 2][j] == 2 && dungeon[i + 1][j - 1] == 18 && dungeon[i + 1][j + 1] == 1)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j + 1] == 1 && dungeon[i + 1][j - 1] == 22 && dungeon[i + 2][j] == 3)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 28 && dungeon[i + 2][j] == 30 && dungeon[i + 1][j - 1] == 6)
-				dungeon[i + 1][j] = 23;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 28 && dungeon[i + 2][j] == 1)
-				dungeon[i + 1][j] = 23;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 27 && dungeon[i + 1][j + 1] == 30)
-				dungeon[i + 1][j] = 29;
-			if (dungeon[i][j] == 28 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j - 1] == 21)
-				dungeon[i + 1][j] = 24;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 27 && dungeon[i + 1][j + 1] == 30)
-				dungeon[i + 1][j] = 29;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 18)
-				dungeon[i + 1][j] = 25;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 9 && dungeon[i + 2][j] == 2)
-				dungeon[i + 1][j] = 11;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 10)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 15 && dungeon[i][j + 1] == 3)
-				dungeon[i][j + 1] = 4;
-			if (dungeon[i][j] == 22 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 18 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 18;
-			if (dungeon[i][j] == 24 && dungeon[i - 1][j] == 30)
-				dungeon[i - 1][j] = 19;
-			if (dungeon[i][j] == 21 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 21 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 10;
-			if (dungeon[i][j] == 22 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 18;
-			if (dungeon[i][j] == 21 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 18;
-			if (dungeon[i][j] == 16 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 13 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 22 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 18 && dungeon[i + 2][j] == 30)
-				dungeon[i + 1][j] = 24;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 9 && dungeon[i + 1][j + 1] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 27 && dungeon[i + 1][j + 1] == 2)
-				dungeon[i + 1][j] = 29;
-			if (dungeon[i][j] == 23 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 23 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 25 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 22 && dungeon[i + 1][j] == 9)
-				dungeon[i + 1][j] = 11;
-			if (dungeon[i][j] == 23 && dungeon[i + 1][j] == 9)
-				dungeon[i + 1][j] = 11;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 11 && dungeon[i + 1][j] == 15)
-				dungeon[i + 1][j] = 14;
-			if (dungeon[i][j] == 23 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 27)
-				dungeon[i + 1][j] = 26;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 18)
-				dungeon[i + 1][j] = 24;
-			if (dungeon[i][j] == 26 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 29 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 29 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 1 && dungeon[i][j - 1] == 15)
-				dungeon[i][j - 1] = 10;
-			if (dungeon[i][j] == 18 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 23 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 18;
-			if (dungeon[i][j] == 18 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 10;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 30 && dungeon[i + 1][j + 1] == 30)
-				dungeon[i + 1][j] = 23;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 28 && dungeon[i + 1][j - 1] == 6)
-				dungeon[i + 1][j] = 23;
-			if (dungeon[i][j] == 23 && dungeon[i + 1][j] == 18 && dungeon[i][j - 1] == 6)
-				dungeon[i + 1][j] = 24;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 23 && dungeon[i + 2][j] == 30)
-				dungeon[i + 1][j] = 28;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 28 && dungeon[i + 2][j] == 30 && dungeon[i + 1][j - 1] == 6)
-				dungeon[i + 1][j] = 23;
-			if (dungeon[i][j] == 23 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 19;
-			if (dungeon[i][j] == 29 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 19;
-			if (dungeon[i][j] == 29 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 18;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 19;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 19;
-			if (dungeon[i][j] == 26 && dungeon[i + 1][j] == 30)
-				dungeon[i + 1][j] = 19;
-			if (dungeon[i][j] == 16 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 18;
-			if (dungeon[i][j] == 13 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 10;
-			if (dungeon[i][j] == 25 && dungeon[i][j + 1] == 30)
-				dungeon[i][j + 1] = 18;
-			if (dungeon[i][j] == 18 && dungeon[i][j + 1] == 2)
-				dungeon[i][j + 1] = 15;
-			if (dungeon[i][j] == 11 && dungeon[i + 1][j] == 3)
-				dungeon[i + 1][j] = 5;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 9)
-				dungeon[i + 1][j] = 11;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 13;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 13 && dungeon[i + 1][j - 1] == 6)
-				dungeon[i + 1][j] = 16;
-		}
-	}
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (dungeon[i][j] == 21 && dungeon[i][j + 1] == 24 && dungeon[i][j + 2] == 1)
-				dungeon[i][j + 1] = 17;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j + 1] == 9 && dungeon[i + 1][j - 1] == 1 && dungeon[i + 2][j] == 16)
-				dungeon[i + 1][j] = 29;
-			if (dungeon[i][j] == 2 && dungeon[i - 1][j] == 6)
-				dungeon[i - 1][j] = 8;
-			if (dungeon[i][j] == 1 && dungeon[i][j - 1] == 6)
-				dungeon[i][j - 1] = 7;
-			if (dungeon[i][j] == 6 && dungeon[i + 1][j] == 15 && dungeon[i + 1][j + 1] == 4)
-				dungeon[i + 1][j] = 10;
-			if (dungeon[i][j] == 1 && dungeon[i][j + 1] == 3)
-				dungeon[i][j + 1] = 4;
-			if (dungeon[i][j] == 1 && dungeon[i][j + 1] == 6)
-				dungeon[i][j + 1] = 4;
-			if (dungeon[i][j] == 9 && dungeon[i][j + 1] == 3)
-				dungeon[i][j + 1] = 4;
-			if (dungeon[i][j] == 10 && dungeon[i][j + 1] == 3)
-				dungeon[i][j + 1] = 4;
-			if (dungeon[i][j] == 13 && dungeon[i][j + 1] == 3)
-				dungeon[i][j + 1] = 4;
-			if (dungeon[i][j] == 1 && dungeon[i][j + 1] == 5)
-				dungeon[i][j + 1] = 12;
-			if (dungeon[i][j] == 1 && dungeon[i][j + 1] == 16)
-				dungeon[i][j + 1] = 13;
-			if (dungeon[i][j] == 6 && dungeon[i][j + 1] == 13)
-				dungeon[i][j + 1] = 16;
-			if (dungeon[i][j] == 25 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 10;
-			if (dungeon[i][j] == 13 && dungeon[i][j + 1] == 5)
-				dungeon[i][j + 1] = 12;
-			if (dungeon[i][j] == 28 && dungeon[i][j - 1] == 6 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 23;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 10)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 9)
-				dungeon[i + 1][j] = 11;
-			if (dungeon[i][j] == 11 && dungeon[i + 1][j] == 3)
-				dungeon[i + 1][j] = 5;
-			if (dungeon[i][j] == 10 && dungeon[i + 1][j] == 4)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 4)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 27 && dungeon[i + 1][j] == 9)
-				dungeon[i + 1][j] = 11;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 4)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 1)
-				dungeon[i + 1][j] = 16;
-			if (dungeon[i][j] == 11 && dungeon[i + 1][j] == 4)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 3)
-				dungeon[i + 1][j] = 5;
-			if (dungeon[i][j] == 9 && dungeon[i + 1][j] == 3)
-				dungeon[i + 1][j] = 5;
-			if (dungeon[i][j] == 14 && dungeon[i + 1][j] == 3)
-				dungeon[i + 1][j] = 5;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 3)
-				dungeon[i + 1][j] = 5;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 5 && dungeon[i + 1][j - 1] == 16)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 2 && dungeon[i + 1][j] == 4)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 9 && dungeon[i + 1][j] == 4)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 1 && dungeon[i][j - 1] == 8)
-				dungeon[i][j - 1] = 9;
-			if (dungeon[i][j] == 28 && dungeon[i + 1][j] == 23 && dungeon[i + 1][j + 1] == 3)
-				dungeon[i + 1][j] = 16;
-		}
-	}
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 10)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 17 && dungeon[i + 1][j] == 4)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 10 && dungeon[i + 1][j] == 4)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 17 && dungeon[i][j + 1] == 5)
-				dungeon[i][j + 1] = 12;
-			if (dungeon[i][j] == 29 && dungeon[i][j + 1] == 9)
-				dungeon[i][j + 1] = 10;
-			if (dungeon[i][j] == 13 && dungeon[i][j + 1] == 5)
-				dungeon[i][j + 1] = 12;
-			if (dungeon[i][j] == 9 && dungeon[i][j + 1] == 16)
-				dungeon[i][j + 1] = 13;
-			if (dungeon[i][j] == 10 && dungeon[i][j + 1] == 16)
-				dungeon[i][j + 1] = 13;
-			if (dungeon[i][j] == 16 && dungeon[i][j + 1] == 3)
-				dungeon[i][j + 1] = 4;
-			if (dungeon[i][j] == 11 && dungeon[i][j + 1] == 5)
-				dungeon[i][j + 1] = 12;
-			if (dungeon[i][j] == 10 && dungeon[i + 1][j] == 3 && dungeon[i + 1][j - 1] == 16)
-				dungeon[i + 1][j] = 12;
-			if (dungeon[i][j] == 16 && dungeon[i][j + 1] == 5)
-				dungeon[i][j + 1] = 12;
-			if (dungeon[i][j] == 1 && dungeon[i][j + 1] == 6)
-				dungeon[i][j + 1] = 4;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j] == 13 && dungeon[i][j + 1] == 10)
-				dungeon[i + 1][j + 1] = 12;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 10)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 22 && dungeon[i][j + 1] == 11)
-				dungeon[i][j + 1] = 17;
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 28 && dungeon[i + 2][j] == 16)
-				dungeon[i + 1][j] = 23;
-			if (dungeon[i][j] == 28 && dungeon[i + 1][j] == 23 && dungeon[i + 1][j + 1] == 1 && dungeon[i + 2][j] == 6)
-				dungeon[i + 1][j] = 16;
-		}
-	}
-	for (j = 0; j < DMAXY; j++) {
-		for (i = 0; i < DMAXX; i++) {
-			if (dungeon[i][j] == 15 && dungeon[i + 1][j] == 28 && dungeon[i + 2][j] == 16)
-				dungeon[i + 1][j] = 23;
-			if (dungeon[i][j] == 21 && dungeon[i + 1][j - 1] == 21 && dungeon[i + 1][j + 1] == 13 && dungeon[i + 2][j] == 2)
-				dungeon[i + 1][j] = 17;
-			if (dungeon[i][j] == 19 && dungeon[i + 1][j] == 15 && dungeon[i + 1][j + 1] == 12)
-				dungeon[i + 1][j] = 17;
-		}
-	}
+	// The L4 rules index dungeon directly, neighbours past the edges are not bounds checked
+	ApplyTileRules(L4TileFix1, dungeon, TileAccess::Unchecked);
+	ApplyTileRules(L4TileFix2, dungeon, TileAccess::Unchecked);
+	ApplyTileRules(L4TileFix3, dungeon, TileAccess::Unchecked);
+	ApplyTileRules(L4TileFix4, dungeon, TileAccess::Unchecked);
+	ApplyTileRules(L4TileFix5, dungeon, TileAccess::Unchecked);
+	ApplyTileRules(L4TileFix6, dungeon, TileAccess::Unchecked);
 }
 
 static void DRLG_L4Subs()
@@ -932,7 +760,7 @@ static void DRLG_L4Subs()
 		for (x = 0; x < DMAXX; x++) {
 			rv = random_(0, 3);
 			if (rv == 0) {
-				c = GetDungeon(x, y);
+				c = dungeon[x][y];
 				c = L4BTYPES[c];
 				if (c != 0 && dflags[x][y] == 0) {
 					rv = random_(0, 16);
@@ -946,7 +774,7 @@ static void DRLG_L4Subs()
 							rv--;
 						}
 					}
-					SetDungeon(x, y, i);
+					dungeon[x][y] = i;
 				}
 			}
 		}
@@ -955,9 +783,9 @@ static void DRLG_L4Subs()
 		for (x = 0; x < DMAXX; x++) {
 			rv = random_(0, 10);
 			if (rv == 0) {
-				c = GetDungeon(x, y);
+				c = dungeon[x][y];
 				if (L4BTYPES[c] == 6 && dflags[x][y] == 0) {
-					SetDungeon(x, y, random_(0, 3) + 95);
+					dungeon[x][y] = random_(0, 3) + 95;
 				}
 			}
 		}
@@ -1335,8 +1163,9 @@ void DRLG_LoadDiabQuads(BOOL preflag)
 
 static BOOL DRLG_L4PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx, int cy, BOOL setview, int ldir)
 {
-	int sx, sy, sw, sh, xx, yy, i, ii, numt, bailcnt;
+	int sx, sy, sw, sh, xx, yy, i, ii, numt, bailcnt, skip;
 	BOOL found;
+	MiniSetIndex index;
 
 	sw = miniset[0];
 	sh = miniset[1];
@@ -1347,11 +1176,28 @@ static BOOL DRLG_L4PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx,
 		numt = random_(0, tmax - tmin) + tmin;
 	}
 
+	index.Build(miniset, dungeon, (const BYTE(*)[DMAXY])dflags);
+	index.Exclude(SP4x1, SP4y1, SP4x2, SP4y2);
+	if (cx != -1) {
+		index.Stop(cx - sw, 0, cx + 12, DMAXY);
+	}
+	if (cy != -1) {
+		index.Stop(0, cy - sh, DMAXX, cy + 12);
+	}
+
 	for (i = 0; i < numt; i++) {
 		sx = random_(0, DMAXX - sw);
 		sy = random_(0, DMAXY - sh);
 		found = FALSE;
 		for (bailcnt = 0; !found && bailcnt < 200; bailcnt++) {
+			// Jump over the positions that would only be stepped over
+			skip = index.Distance(sx, sy, 200 - bailcnt);
+			bailcnt += skip;
+			if (bailcnt >= 200) {
+				break;
+			}
+			index.Advance(sx, sy, skip);
+
 			found = TRUE;
 			if (sx >= SP4x1 && sx <= SP4x2 && sy >= SP4y1 && sy <= SP4y2) {
 				found = FALSE;
@@ -1366,17 +1212,8 @@ static BOOL DRLG_L4PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx,
 				sy = random_(0, DMAXY - sh);
 				found = FALSE;
 			}
-			ii = 2;
-			for (yy = 0; yy < sh && found == TRUE; yy++) {
-				for (xx = 0; xx < sw && found == TRUE; xx++) {
-					if (miniset[ii] != 0 && GetDungeon(xx + sx, yy + sy) != miniset[ii]) {
-						found = FALSE;
-					}
-					if (dflags[xx + sx][yy + sy] != 0) {
-						found = FALSE;
-					}
-					ii++;
-				}
+			if (found == TRUE && !index.Matches(sx, sy)) {
+				found = FALSE;
 			}
 			if (!found) {
 				sx++;
@@ -1402,6 +1239,7 @@ static BOOL DRLG_L4PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx,
 				ii++;
 			}
 		}
+		index.Update(sx, sy);
 	}
 
 	if (currlevel == 15) {
@@ -1420,53 +1258,6 @@ static BOOL DRLG_L4PlaceMiniSet(const BYTE *miniset, int tmin, int tmax, int cx,
 	return TRUE;
 }
 
-static void DRLG_L4FTVR(int i, int j, int x, int y, int d)
-{
-	if (dTransVal[x][y] != 0 || GetDungeon(i, j) != 6) {
-		if (d == 1) {
-			dTransVal[x][y] = TransVal;
-			dTransVal[x][y + 1] = TransVal;
-		}
-		if (d == 2) {
-			dTransVal[x + 1][y] = TransVal;
-			dTransVal[x + 1][y + 1] = TransVal;
-		}
-		if (d == 3) {
-			dTransVal[x][y] = TransVal;
-			dTransVal[x + 1][y] = TransVal;
-		}
-		if (d == 4) {
-			dTransVal[x][y + 1] = TransVal;
-			dTransVal[x + 1][y + 1] = TransVal;
-		}
-		if (d == 5) {
-			dTransVal[x + 1][y + 1] = TransVal;
-		}
-		if (d == 6) {
-			dTransVal[x][y + 1] = TransVal;
-		}
-		if (d == 7) {
-			dTransVal[x + 1][y] = TransVal;
-		}
-		if (d == 8) {
-			dTransVal[x][y] = TransVal;
-		}
-	} else {
-		dTransVal[x][y] = TransVal;
-		dTransVal[x + 1][y] = TransVal;
-		dTransVal[x][y + 1] = TransVal;
-		dTransVal[x + 1][y + 1] = TransVal;
-		DRLG_L4FTVR(i + 1, j, x + 2, y, 1);
-		DRLG_L4FTVR(i - 1, j, x - 2, y, 2);
-		DRLG_L4FTVR(i, j + 1, x, y + 2, 3);
-		DRLG_L4FTVR(i, j - 1, x, y - 2, 4);
-		DRLG_L4FTVR(i - 1, j - 1, x - 2, y - 2, 5);
-		DRLG_L4FTVR(i + 1, j - 1, x + 2, y - 2, 6);
-		DRLG_L4FTVR(i - 1, j + 1, x - 2, y + 2, 7);
-		DRLG_L4FTVR(i + 1, j + 1, x + 2, y + 2, 8);
-	}
-}
-
 static void DRLG_L4FloodTVal()
 {
 	int i, j, xx, yy;
@@ -1475,8 +1266,8 @@ static void DRLG_L4FloodTVal()
 	for (j = 0; j < DMAXY; j++) {
 		xx = 16;
 		for (i = 0; i < DMAXX; i++) {
-			if (GetDungeon(i, j) == 6 && dTransVal[xx][yy] == 0) {
-				DRLG_L4FTVR(i, j, xx, yy, 0);
+			if (dungeon[i][j] == 6 && dTransVal[xx][yy] == 0) {
+				DRLG_FloodTransVal(i, j, xx, yy, 6);
 				TransVal++;
 			}
 			xx += 2;
@@ -1523,32 +1314,32 @@ static void DRLG_L4TransFix()
 	for (j = 0; j < DMAXY; j++) {
 		xx = 16;
 		for (i = 0; i < DMAXX; i++) {
-			if (IsDURWall(GetDungeon(i, j)) && GetDungeon(i, j - 1) == 18) {
+			if (IsDURWall(dungeon[i][j]) && GetDungeon(i, j - 1) == 18) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (IsDLLWall(GetDungeon(i, j)) && GetDungeon(i + 1, j) == 19) {
+			if (IsDLLWall(dungeon[i][j]) && GetDungeon(i + 1, j) == 19) {
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 18) {
+			if (dungeon[i][j] == 18) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 19) {
+			if (dungeon[i][j] == 19) {
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 24) {
+			if (dungeon[i][j] == 24) {
 				dTransVal[xx + 1][yy] = dTransVal[xx][yy];
 				dTransVal[xx][yy + 1] = dTransVal[xx][yy];
 				dTransVal[xx + 1][yy + 1] = dTransVal[xx][yy];
 			}
-			if (GetDungeon(i, j) == 57) {
+			if (dungeon[i][j] == 57) {
 				dTransVal[xx - 1][yy] = dTransVal[xx][yy + 1];
 				dTransVal[xx][yy] = dTransVal[xx][yy + 1];
 			}
-			if (GetDungeon(i, j) == 53) {
+			if (dungeon[i][j] == 53) {
 				dTransVal[xx][yy - 1] = dTransVal[xx + 1][yy];
 				dTransVal[xx][yy] = dTransVal[xx + 1][yy];
 			}
@@ -1564,11 +1355,11 @@ static void DRLG_L4Corners()
 
 	for (j = 1; j < DMAXY - 1; j++) {
 		for (i = 1; i < DMAXX - 1; i++) {
-			if (GetDungeon(i, j) >= 18 && GetDungeon(i, j) <= 30) {
-				if (GetDungeon(i + 1, j) < 18) {
-					SetDungeon(i, j, GetDungeon(i, j) + 98);
-				} else if (GetDungeon(i, j + 1) < 18) {
-					SetDungeon(i, j, GetDungeon(i, j) + 98);
+			if (dungeon[i][j] >= 18 && dungeon[i][j] <= 30) {
+				if (dungeon[i + 1][j] < 18) {
+					dungeon[i][j] = dungeon[i][j] + 98;
+				} else if (dungeon[i][j + 1] < 18) {
+					dungeon[i][j] = dungeon[i][j] + 98;
 				}
 			}
 		}
@@ -1593,8 +1384,8 @@ void DRLG_L4GeneralFix()
 
 	for (j = 0; j < DMAXY - 1; j++) {
 		for (i = 0; i < DMAXX - 1; i++) {
-			if ((GetDungeon(i, j) == 24 || GetDungeon(i, j) == 122) && GetDungeon(i + 1, j) == 2 && GetDungeon(i, j + 1) == 5) {
-				SetDungeon(i, j, 17);
+			if ((dungeon[i][j] == 24 || dungeon[i][j] == 122) && dungeon[i + 1][j] == 2 && dungeon[i][j + 1] == 5) {
+				dungeon[i][j] = 17;
 			}
 		}
 	}
@@ -1737,7 +1528,7 @@ std::optional<uint32_t> DRLG_L4(int entry, DungeonMode mode)
 	if (QuestStatus(Q_WARLORD)) {
 		for (j = 0; j < DMAXY; j++) {
 			for (i = 0; i < DMAXX; i++) {
-				pdungeon[i][j] = GetDungeon(i, j);
+				pdungeon[i][j] = dungeon[i][j];
 			}
 		}
 	}
@@ -1747,10 +1538,10 @@ std::optional<uint32_t> DRLG_L4(int entry, DungeonMode mode)
 	if (currlevel == 15) {
 		for (j = 0; j < DMAXY; j++) {
 			for (i = 0; i < DMAXX; i++) {
-				if (GetDungeon(i, j) == 98) {
+				if (dungeon[i][j] == 98) {
 					Make_SetPC(i - 1, j - 1, 5, 5);
 				}
-				if (GetDungeon(i, j) == 107) {
+				if (dungeon[i][j] == 107) {
 					Make_SetPC(i - 1, j - 1, 5, 5);
 				}
 			}
@@ -1759,7 +1550,7 @@ std::optional<uint32_t> DRLG_L4(int entry, DungeonMode mode)
 	if (currlevel == 16) {
 		for (j = 0; j < DMAXY; j++) {
 			for (i = 0; i < DMAXX; i++) {
-				pdungeon[i][j] = GetDungeon(i, j);
+				pdungeon[i][j] = dungeon[i][j];
 			}
 		}
 		DRLG_LoadDiabQuads(FALSE);
@@ -1770,101 +1561,7 @@ std::optional<uint32_t> DRLG_L4(int entry, DungeonMode mode)
 
 static void DRLG_L4Pass3()
 {
-	int i, j, xx, yy;
-	long v1, v2, v3, v4, lv;
-
-	lv = 30 - 1;
-
-#ifdef USE_ASM
-	__asm {
-		mov		esi, pMegaTiles
-		mov		eax, lv
-		shl		eax, 3
-		add		esi, eax
-		xor		eax, eax
-		lodsw
-		inc		eax
-		mov		v1, eax
-		lodsw
-		inc		eax
-		mov		v2, eax
-		lodsw
-		inc		eax
-		mov		v3, eax
-		lodsw
-		inc		eax
-		mov		v4, eax
-	}
-#else
-	v1 = *((WORD *)&pMegaTiles[lv * 8] + 0) + 1;
-	v2 = *((WORD *)&pMegaTiles[lv * 8] + 1) + 1;
-	v3 = *((WORD *)&pMegaTiles[lv * 8] + 2) + 1;
-	v4 = *((WORD *)&pMegaTiles[lv * 8] + 3) + 1;
-#endif
-
-	for (j = 0; j < MAXDUNY; j += 2)
-	{
-		for (i = 0; i < MAXDUNX; i += 2) {
-			dPiece[i][j] = v1;
-			dPiece[i + 1][j] = v2;
-			dPiece[i][j + 1] = v3;
-			dPiece[i + 1][j + 1] = v4;
-		}
-	}
-
-	yy = 16;
-	for (j = 0; j < DMAXY; j++) {
-		xx = 16;
-		for (i = 0; i < DMAXX; i++) {
-			lv = GetDungeon(i, j) - 1;
-#ifdef USE_ASM
-			if (lv >= 0) {
-				__asm {
-					mov		esi, pMegaTiles
-					mov		eax, lv
-					shl		eax, 3
-					add		esi, eax
-					xor		eax, eax
-					lodsw
-					inc		eax
-					mov		v1, eax
-					lodsw
-					inc		eax
-					mov		v2, eax
-					lodsw
-					inc		eax
-					mov		v3, eax
-					lodsw
-					inc		eax
-					mov		v4, eax
-				}
-			} else {
-				v1 = 0;
-				v2 = 0;
-				v3 = 0;
-				v4 = 0;
-			}
-#else
-			if (lv >= 0) {
-				v1 = *((WORD *)&pMegaTiles[lv * 8] + 0) + 1;
-				v2 = *((WORD *)&pMegaTiles[lv * 8] + 1) + 1;
-				v3 = *((WORD *)&pMegaTiles[lv * 8] + 2) + 1;
-				v4 = *((WORD *)&pMegaTiles[lv * 8] + 3) + 1;
-			} else {
-				v1 = 0;
-				v2 = 0;
-				v3 = 0;
-				v4 = 0;
-			}
-#endif
-			dPiece[xx][yy] = v1;
-			dPiece[xx + 1][yy] = v2;
-			dPiece[xx][yy + 1] = v3;
-			dPiece[xx + 1][yy + 1] = v4;
-			xx += 2;
-		}
-		yy += 2;
-	}
+	DRLG_ExpandMegaTiles(30);
 }
 
 std::optional<uint32_t> CreateL4Dungeon(DWORD rseed, int entry, DungeonMode mode)
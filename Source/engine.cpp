@@ -4,6 +4,8 @@
 #include <iostream>
 #include <malloc.h>
 #include <stdio.h>
+#include <unordered_map>
+#include <vector>
 #ifdef _WIN32
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
@@ -35,6 +37,19 @@ int SeedCount;
 
 int questdebug = -1;
 
+Arena levelArena;
+
+namespace {
+
+/** Contents of the files loaded with LoadLevelFileInMem() */
+std::unordered_map<std::string, std::vector<BYTE>> fileCache;
+/** Tile graphics of each level type, loaded the first time the type is generated */
+BYTE *megaTiles[DTYPE_HELL + 1];
+DWORD megaTilesLen[DTYPE_HELL + 1];
+BYTE *levelPieces[DTYPE_HELL + 1];
+
+}  // namespace
+
 uint64_t micros()
 {
 	auto now = std::chrono::steady_clock::now();
@@ -91,10 +106,13 @@ BYTE *DiabloAllocPtr(DWORD dwBytes)
 
 /**
  * @brief Multithreaded safe memfree
- * @param p Memory pointer to free
+ * @param p Memory pointer to free, memory from levelArena is left for the next reset
  */
 void mem_free_dbg(void *p)
 {
+	if (levelArena.Owns(p))
+		return;
+
 	free(p);
 }
 
@@ -149,31 +167,62 @@ BYTE *LoadFileInMem(std::string pszName, DWORD *pdwFileLen)
 	return buf;
 }
 
-void LoadLvlGFX()
+/**
+ * @brief Load a file into levelArena, the file is only read from disk the first time
+ * @param pszName Path of file
+ * @param pdwFileLen Will be set to file size if non-NULL
+ * @return Buffer with content of file, valid until levelArena is reset
+ */
+BYTE *LoadLevelFileInMem(std::string pszName, DWORD *pdwFileLen)
 {
-	free(pMegaTiles);
-	free(pLevelPieces);
+	BYTE *buf;
 
-	switch (leveltype) {
-	case DTYPE_CATHEDRAL:
-		pMegaTiles = LoadFileInMem("Levels\\L1Data\\L1.TIL", NULL);
-		pLevelPieces = LoadFileInMem("Levels\\L1Data\\L1.MIN", NULL);
-		return;
-	case DTYPE_CATACOMBS:
-		pMegaTiles = LoadFileInMem("Levels\\L2Data\\L2.TIL", NULL);
-		pLevelPieces = LoadFileInMem("Levels\\L2Data\\L2.MIN", NULL);
-		return;
-	case DTYPE_CAVES:
-		pMegaTiles = LoadFileInMem("Levels\\L3Data\\L3.TIL", NULL);
-		pLevelPieces = LoadFileInMem("Levels\\L3Data\\L3.MIN", NULL);
-		return;
-	case DTYPE_HELL:
-		pMegaTiles = LoadFileInMem("Levels\\L4Data\\L4.TIL", NULL);
-		pLevelPieces = LoadFileInMem("Levels\\L4Data\\L4.MIN", NULL);
-		return;
-	default:
-		app_fatal("LoadLvlGFX");
+	auto it = fileCache.find(pszName);
+	if (it == fileCache.end()) {
+		DWORD fileLen;
+		buf = LoadFileInMem(pszName, &fileLen);
+		it = fileCache.emplace(pszName, std::vector<BYTE>(buf, buf + fileLen)).first;
+		free(buf);
 	}
+
+	const std::vector<BYTE> &data = it->second;
+	if (pdwFileLen)
+		*pdwFileLen = data.size();
+
+	buf = (BYTE *)levelArena.Allocate(data.size());
+	memcpy(buf, data.data(), data.size());
+
+	return buf;
+}
+
+void LoadLvlGFX()
+{
+	if (megaTiles[leveltype] == NULL) {
+		switch (leveltype) {
+		case DTYPE_CATHEDRAL:
+			megaTiles[leveltype] = LoadFileInMem("Levels\\L1Data\\L1.TIL", &megaTilesLen[leveltype]);
+			levelPieces[leveltype] = LoadFileInMem("Levels\\L1Data\\L1.MIN", NULL);
+			break;
+		case DTYPE_CATACOMBS:
+			megaTiles[leveltype] = LoadFileInMem("Levels\\L2Data\\L2.TIL", &megaTilesLen[leveltype]);
+			levelPieces[leveltype] = LoadFileInMem("Levels\\L2Data\\L2.MIN", NULL);
+			break;
+		case DTYPE_CAVES:
+			megaTiles[leveltype] = LoadFileInMem("Levels\\L3Data\\L3.TIL", &megaTilesLen[leveltype]);
+			levelPieces[leveltype] = LoadFileInMem("Levels\\L3Data\\L3.MIN", NULL);
+			break;
+		case DTYPE_HELL:
+			megaTiles[leveltype] = LoadFileInMem("Levels\\L4Data\\L4.TIL", &megaTilesLen[leveltype]);
+			levelPieces[leveltype] = LoadFileInMem("Levels\\L4Data\\L4.MIN", NULL);
+			break;
+		default:
+			app_fatal("LoadLvlGFX");
+		}
+	}
+
+	pMegaTiles = megaTiles[leveltype];
+	pLevelPieces = levelPieces[leveltype];
+	FillMegaTileTbls(megaTilesLen[leveltype]);
 }
 
 void app_fatal(const char *dummystring)
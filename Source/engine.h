@@ -2,6 +2,7 @@
 #include "../types.h"
 #include "gendung.h"
 #include "objects.h"
+#include "mapGen/arena.h"
 
 #include <string>
 #define assert_fail(exp) ((void)(exp))
@@ -33,6 +34,8 @@ extern bool zoomflag;
 extern int questdebug;
 extern bool oobread;
 extern bool oobwrite;
+/** Memory for data that is only needed while generating the current level */
+extern Arena levelArena;
 
 /**
  * Get time stamp in microseconds.
@@ -47,46 +50,38 @@ void SetRndSeed(int s);
 int GetRndSeed();
 int GetRndState();
 
+/**
+ * Positions outside of the grid are read the way the original code did, as an offset
+ * into the grid flattened column by column, so only the ends of the grid need checking
+ */
 inline int GetdPiece(int x, int y)
 {
-	if (x < 0 || y < 0 || x >= MAXDUNX || y >= MAXDUNY) {
-		int index = x * MAXDUNY + y;
-		x = index / MAXDUNY;
-		y = index % MAXDUNY;
-		if (x < 0 || y < 0 || x >= MAXDUNX) {
-			oobread = true;
-			return 0;
-		}
+	unsigned index = x * MAXDUNY + y;
+	if (index >= MAXDUNX * MAXDUNY) {
+		oobread = true;
+		return 0;
 	}
-	return dPiece[x][y];
+	return dPiece[index / MAXDUNY][index % MAXDUNY];
 }
 
 inline BYTE GetDungeon(int x, int y)
 {
-	if (x < 0 || y < 0 || x >= DMAXX || y >= DMAXY) {
-		int index = x * DMAXY + y;
-		x = index / DMAXY;
-		y = index % DMAXY;
-		if (x < 0 || y < 0 || x >= DMAXX) {
-			oobread = true;
-			return 0;
-		}
+	unsigned index = x * DMAXY + y;
+	if (index >= DMAXX * DMAXY) {
+		oobread = true;
+		return 0;
 	}
-	return dungeon[x][y];
+	return dungeon[index / DMAXY][index % DMAXY];
 }
 
 inline void SetDungeon(int x, int y, BYTE value)
 {
-	if (x < 0 || y < 0 || x >= DMAXX || y >= DMAXY) {
-		int index = x * DMAXY + y;
-		x = index / DMAXY;
-		y = index % DMAXY;
-		if (x < 0 || y < 0 || x >= DMAXX) {
-			oobwrite = true;
-			return;
-		}
+	unsigned index = x * DMAXY + y;
+	if (index >= DMAXX * DMAXY) {
+		oobwrite = true;
+		return;
 	}
-	dungeon[x][y] = value;
+	dungeon[index / DMAXY][index % DMAXY] = value;
 }
 
 inline void SetObjectSelFlag(int id, int value)
@@ -110,6 +105,7 @@ inline void IncrementObjectFrame(int id, int value)
 BYTE *DiabloAllocPtr(DWORD dwBytes);
 void mem_free_dbg(void *p);
 BYTE *LoadFileInMem(std::string pszName, DWORD *pdwFileLen);
+BYTE *LoadLevelFileInMem(std::string pszName, DWORD *pdwFileLen);
 void LoadLvlGFX();
 
 void SetMapObjects(BYTE *pMap, int startx, int starty);
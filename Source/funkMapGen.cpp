@@ -1,6 +1,5 @@
 #include "funkMapGen.h"
 
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
@@ -8,7 +7,6 @@
 #include <sstream>
 #include <string>
 #include <string_view>
-#include <vector>
 
 #include "analyzer/gameseed.h"
 #include "analyzer/path.h"
@@ -25,6 +23,12 @@
 #include "items.h"
 #include "level.h"
 #include "lighting.h"
+#include "mapGen/attributes.h"
+#include "mapGen/levelCache.h"
+#include "mapGen/levelOrder.h"
+#include "mapGen/levelType.h"
+#include "mapGen/results.h"
+#include "mapGen/seedList.h"
 #include "monster.h"
 #include "objects.h"
 #include "quests.h"
@@ -48,6 +52,14 @@ constexpr uint64_t ProgressInterval = 10 * 1000 * 1000;
 
 BYTE previousLevelType = DTYPE_NONE;
 Scanner *scanner;
+LevelOrder levelOrder;
+SeedReader seedReader;
+SeedWriter seedWriter;
+ResultSink resultSink;
+LevelCache levelCache;
+AttributeWriter attributeWriter;
+/** Attributes recorded for the level being scanned */
+AttributeRow attributeRow;
 
 void InitEngine()
 {
@@ -74,12 +86,21 @@ void InitEngine()
 	} else if (Config.scanner == Scanners::GameSeed) {
 		scanner = new ScannerGameSeed();
 	}
+
+	// Levels are printed/exported in the order they are generated, so keep it stable
+	if (!Config.asciiLevels && !Config.exportLevels && !Config.verbose)
+		levelOrder.setLevels(scanner->independentLevels());
 }
 
 void ShutDownEngine()
 {
 	DRLG_UnloadL2SP();
 	DRLG_FreeDiabQuads();
+	CloseDunArchive();
+	seedWriter.Close();
+	resultSink.Close();
+	levelCache.Close();
+	attributeWriter.Close();
 	delete scanner;
 }
 
@@ -90,6 +111,7 @@ void InitiateLevel(int level)
 
 	oobread = false;
 	oobwrite = false;
+	levelArena.Reset();
 
 	if (level > 12)
 		leveltype = DTYPE_HELL;
@@ -110,19 +132,21 @@ void InitiateLevel(int level)
 	FillSolidBlockTbls();
 }
 
+template <int LevelType>
 void InitTriggers()
 {
-	if (leveltype == DTYPE_CATHEDRAL)
+	if constexpr (LevelType == DTYPE_CATHEDRAL)
 		InitL1Triggers();
-	else if (leveltype == DTYPE_CATACOMBS)
+	else if constexpr (LevelType == DTYPE_CATACOMBS)
 		InitL2Triggers();
-	else if (leveltype == DTYPE_CAVES)
+	else if constexpr (LevelType == DTYPE_CAVES)
 		InitL3Triggers();
-	else if (leveltype == DTYPE_HELL)
+	else if constexpr (LevelType == DTYPE_HELL)
 		InitL4Triggers();
 	Freeupstairs();
 }
 
+template <int LevelType>
 void FindStairCordinates()
 {
 	Spawn = { -1, -1 };
@@ -132,13 +156,13 @@ void FindStairCordinates()
 		if (trigs[i]._tmsg == WM_DIABNEXTLVL) {
 			StairsDown = { trigs[i]._tx, trigs[i]._ty };
 		} else if (trigs[i]._tmsg == WM_DIABPREVLVL) {
-			if (leveltype == DTYPE_CATHEDRAL)
+			if constexpr (LevelType == DTYPE_CATHEDRAL)
 				Spawn = { trigs[i]._tx + 1, trigs[i]._ty + 2 };
-			else if (leveltype == DTYPE_CATACOMBS)
+			else if constexpr (LevelType == DTYPE_CATACOMBS)
 				Spawn = { trigs[i]._tx + 1, trigs[i]._ty + 1 };
-			else if (leveltype == DTYPE_CAVES)
+			else if constexpr (LevelType == DTYPE_CAVES)
 				Spawn = { trigs[i]._tx, trigs[i]._ty + 1 };
-			else if (leveltype == DTYPE_HELL)
+			else if constexpr (LevelType == DTYPE_HELL)
 				Spawn = { trigs[i]._tx + 1, trigs[i]._ty };
 		}
 	}
@@ -162,21 +186,25 @@ void CreateDungeonContent()
 	CreateThemeRooms();
 }
 
+/**
+ * @brief Generate the current level, the pipeline is instantiated once per level type
+ */
+template <int LevelType>
 std::optional<uint32_t> CreateDungeon(DungeonMode mode)
 {
 	uint32_t lseed = glSeedTbl[currlevel];
 	std::optional<uint32_t> levelSeed = std::nullopt;
-	if (leveltype == DTYPE_CATHEDRAL)
+	if constexpr (LevelType == DTYPE_CATHEDRAL)
 		levelSeed = CreateL5Dungeon(lseed, 0, mode);
-	if (leveltype == DTYPE_CATACOMBS)
+	else if constexpr (LevelType == DTYPE_CATACOMBS)
 		levelSeed = CreateL2Dungeon(lseed, 0, mode);
-	if (leveltype == DTYPE_CAVES)
+	else if constexpr (LevelType == DTYPE_CAVES)
 		levelSeed = CreateL3Dungeon(lseed, 0, mode);
-	if (leveltype == DTYPE_HELL)
+	else if constexpr (LevelType == DTYPE_HELL)
 		levelSeed = CreateL4Dungeon(lseed, 0, mode);
 
 	if (mode == DungeonMode::Full || mode == DungeonMode::NoContent || mode == DungeonMode::BreakOnFailureOrNoContent) {
-		InitTriggers();
+		InitTriggers<LevelType>();
 
 		if (mode != DungeonMode::NoContent && mode != DungeonMode::BreakOnFailureOrNoContent)
 			CreateDungeonContent();
@@ -188,7 +216,7 @@ std::optional<uint32_t> CreateDungeon(DungeonMode mode)
 				POI = point;
 		}
 
-		FindStairCordinates();
+		FindStairCordinates<LevelType>();
 	}
 
 	if (Config.verbose && oobwrite)
@@ -214,13 +242,32 @@ void SetGameSeed(uint32_t seed)
 	memset(UniqueItemFlag, 0, sizeof(UniqueItemFlag));
 }
 
-std::vector<uint32_t> readFromFile()
+void OpenSeedFiles()
 {
+	if (!Config.seedsOut.empty() && !seedWriter.Open(Config.seedsOut, Config.seedsOutVarint)) {
+		std::cerr << "Unable to create seeds file: " << Config.seedsOut << std::endl;
+		exit(255);
+	}
+
+	if (!Config.resultsFile.empty() && !resultSink.Open(Config.resultsFile)) {
+		std::cerr << "Unable to create results file: " << Config.resultsFile << std::endl;
+		exit(255);
+	}
+
+	if (!Config.levelCache.empty() && !levelCache.Open(Config.levelCache)) {
+		std::cerr << "Unable to open level cache: " << Config.levelCache << std::endl;
+		exit(255);
+	}
+
+	if (!Config.attributesFile.empty() && !attributeWriter.Open(Config.attributesFile)) {
+		std::cerr << "Unable to open attribute file: " << Config.attributesFile << std::endl;
+		exit(255);
+	}
+
 	if (Config.seedFile.empty())
-		return {};
+		return;
 
-	std::ifstream file(Config.seedFile);
-	if (!file.is_open()) {
+	if (!seedReader.Open(Config.seedFile)) {
 		std::cerr << "Unable to read seeds file: " << Config.seedFile << std::endl;
 		exit(255);
 	}
@@ -228,17 +275,8 @@ std::vector<uint32_t> readFromFile()
 	if (!Config.quiet)
 		std::cerr << "Loading seeds from: " << Config.seedFile << std::endl;
 
-	std::vector<uint32_t> SeedsFromFile;
-	std::string line;
-	while (std::getline(file, line))
-		SeedsFromFile.push_back(std::stoll(line.substr(0, line.find(' '))));
-
-	Config.seedCount = std::min(Config.seedCount, uint32_t(SeedsFromFile.size() - Config.startSeed));
-
-	if (file.is_open())
-		file.close();
-
-	return SeedsFromFile;
+	Config.seedCount = std::min<uint64_t>(Config.seedCount, seedReader.Count() - Config.startSeed);
+	seedReader.Skip(Config.startSeed);
 }
 
 int ProgressseedMicros;
@@ -281,6 +319,196 @@ void printProgress(uint32_t seedIndex, uint32_t seed)
 	std::cerr << oss.str();
 }
 
+void PackUniqueItems(uint32_t (&bits)[4])
+{
+	static_assert(sizeof(UniqueItemFlag) / sizeof(*UniqueItemFlag) <= 4 * 32);
+
+	for (int i = 0; i < sizeof(UniqueItemFlag) / sizeof(*UniqueItemFlag); i++) {
+		if (UniqueItemFlag[i])
+			bits[i / 32] |= 1U << (i % 32);
+	}
+}
+
+LevelKey CurrentLevelKey(DungeonMode mode)
+{
+	LevelKey key {};
+	key.dungeonSeed = glSeedTbl[currlevel];
+	for (int i = 0; i < MAXQUESTS; i++) {
+		if (quests[i]._qactive != QUEST_NOTAVAIL)
+			key.questMask |= 1U << i;
+	}
+	PackUniqueItems(key.uniqueItems);
+	key.level = currlevel;
+	key.mode = static_cast<uint8_t>(mode);
+
+	return key;
+}
+
+void StoreLevelFeatures(const LevelKey &key, std::optional<uint32_t> levelSeed)
+{
+	LevelFeatures features {};
+	features.key = key;
+	features.levelSeed = levelSeed.value_or(0);
+	features.flags = levelSeed ? LevelHasLevelSeed : 0;
+	features.spawnX = Spawn.x;
+	features.spawnY = Spawn.y;
+	features.stairsDownX = StairsDown.x;
+	features.stairsDownY = StairsDown.y;
+	features.poiX = POI.x;
+	features.poiY = POI.y;
+	if (key.mode == static_cast<uint8_t>(DungeonMode::Full)) {
+		features.monsterTypeCount = nummtypes;
+		for (int i = 0; i < nummtypes; i++)
+			features.monsterTypes[i] = Monsters[i].mtype;
+		features.monsterCount = nummonsters;
+		features.objectCount = nobjects;
+		features.itemCount = numitems;
+	}
+	PackUniqueItems(features.uniqueItemsAfter);
+
+	levelCache.Add(features);
+}
+
+/**
+ * @brief Restore the state the level left behind for the scanner and the following levels
+ */
+std::optional<uint32_t> LoadLevelFeatures(const LevelFeatures &features)
+{
+	Spawn = { features.spawnX, features.spawnY };
+	StairsDown = { features.stairsDownX, features.stairsDownY };
+	POI = { features.poiX, features.poiY };
+	for (int i = 0; i < sizeof(UniqueItemFlag) / sizeof(*UniqueItemFlag); i++)
+		UniqueItemFlag[i] = (features.uniqueItemsAfter[i / 32] >> (i % 32)) & 1;
+
+	if ((features.flags & LevelHasLevelSeed) == 0)
+		return std::nullopt;
+	return features.levelSeed;
+}
+
+/**
+ * @brief The mode generates the whole level and locates its stairs, so its features can be cached
+ */
+bool IsCachedMode(DungeonMode mode)
+{
+	return mode == DungeonMode::Full || mode == DungeonMode::NoContent;
+}
+
+/**
+ * @brief Generate the current level, or take it from the level cache if the scanner allows it
+ */
+std::optional<uint32_t> GenerateLevel(DungeonMode mode)
+{
+	auto generate = [mode](auto levelType) {
+		return CreateDungeon<decltype(levelType)::value>(mode);
+	};
+
+	if (!levelCache.IsOpen() || !scanner->usesLevelFeaturesOnly() || !IsCachedMode(mode))
+		return DispatchLevelType(generate);
+
+	LevelKey key = CurrentLevelKey(mode);
+	const LevelFeatures *features = levelCache.Find(key);
+	// Printing and exporting need the actual level
+	if (features != nullptr && !Config.asciiLevels && !Config.exportLevels)
+		return LoadLevelFeatures(*features);
+
+	std::optional<uint32_t> levelSeed = DispatchLevelType(generate);
+	if (features == nullptr)
+		StoreLevelFeatures(key, levelSeed);
+
+	return levelSeed;
+}
+
+/**
+ * @brief Print the game seeds of the attribute file that match --query
+ */
+void RunQuery()
+{
+	std::optional<std::vector<AttributeFilter>> filters = ParseAttributeFilters(Config.query);
+	if (!filters) {
+		std::cerr << "Invalid query: " << Config.query << std::endl;
+		exit(255);
+	}
+
+	std::optional<std::vector<uint32_t>> seeds = QueryAttributes(Config.attributesFile, *filters);
+	if (!seeds) {
+		std::cerr << "Unable to read attribute file: " << Config.attributesFile << std::endl;
+		exit(255);
+	}
+
+	for (uint32_t seed : *seeds)
+		std::cout << seed << std::endl;
+}
+
+bool ScanLevel(uint32_t seed, int level)
+{
+	InitiateLevel(level);
+	attributeRow = {};
+	attributeRow.gameSeed = seed;
+	attributeRow.level = level;
+
+	std::optional<uint32_t> levelSeed = GenerateLevel(scanner->getDungeonMode());
+	if (levelSeed)
+		Scanner::recordAttribute(Attribute::LevelSeed, static_cast<int32_t>(*levelSeed));
+
+	bool matches = scanner->levelMatches(levelSeed);
+	if (attributeWriter.IsOpen() && attributeRow.present != 0)
+		attributeWriter.Append(attributeRow);
+	if (!matches)
+		return false;
+
+	if (Config.asciiLevels)
+		printAsciiLevel();
+	if (Config.exportLevels)
+		ExportDun(seed);
+
+	return true;
+}
+
+/**
+ * @brief Generate the scanner's independent levels, the ones most likely to reject the seed first
+ * @return False if the seed was rejected
+ */
+bool ScanIndependentLevels(uint32_t seed)
+{
+	for (int level : levelOrder.levels()) {
+		if (scanner->skipLevel(level))
+			continue;
+
+		uint64_t start = micros();
+		bool matches = ScanLevel(seed, level);
+		levelOrder.record(level, matches, micros() - start);
+		if (!matches)
+			return false;
+	}
+
+	return true;
+}
+
+}
+
+void Scanner::report(std::optional<uint32_t> levelSeed, int32_t metric)
+{
+	ResultRecord record {};
+	record.gameSeed = sgGameInitInfo.dwSeed;
+	record.levelSeed = levelSeed.value_or(0);
+	record.metric = metric;
+	record.level = currlevel;
+	record.scanner = static_cast<uint8_t>(Config.scanner);
+	record.flags = levelSeed ? ResultHasLevelSeed : 0;
+
+	if (seedWriter.IsOpen())
+		seedWriter.Write(record.gameSeed);
+
+	if (resultSink.IsOpen())
+		resultSink.Append(record);
+	else
+		std::cout << FormatResult(record) << std::endl;
+}
+
+void Scanner::recordAttribute(Attribute attribute, int32_t value)
+{
+	attributeRow.values[static_cast<int>(attribute)] = value;
+	attributeRow.present |= 1 << static_cast<int>(attribute);
 }
 
 void InitDungeonMonsters()
@@ -293,34 +521,33 @@ void InitDungeonMonsters()
 int main(int argc, char **argv)
 {
 	Config = Configuration::ParseArguments(argc, argv);
+	if (!Config.query.empty()) {
+		RunQuery();
+		return 0;
+	}
+
 	InitEngine();
-	std::vector<uint32_t> SeedsFromFile = readFromFile();
+	OpenSeedFiles();
 
 	ProgressseedMicros = micros();
 	for (uint32_t seedIndex = 0; seedIndex < Config.seedCount; seedIndex++) {
 		uint32_t seed = seedIndex + Config.startSeed;
-		if (!SeedsFromFile.empty()) {
-			seed = SeedsFromFile[seed];
-		}
+		if (!Config.seedFile.empty())
+			seed = seedReader.Next();
 		printProgress(seedIndex, seed);
 
 		SetGameSeed(seed);
 		if (scanner->skipSeed())
 			continue;
 
-		for (int level = 1; level < NUMLEVELS; level++) {
-			if (scanner->skipLevel(level))
-				continue;
+		if (!ScanIndependentLevels(seed))
+			continue;
 
-			InitiateLevel(level);
-			std::optional<uint32_t> levelSeed = CreateDungeon(scanner->getDungeonMode());
-			if (!scanner->levelMatches(levelSeed))
+		for (int level = 1; level < NUMLEVELS; level++) {
+			if (levelOrder.contains(level) || scanner->skipLevel(level))
 				continue;
 
-			if (Config.asciiLevels)
-				printAsciiLevel();
-			if (Config.exportLevels)
-				ExportDun(seed);
+			ScanLevel(seed, level);
 		}
 	}
 
@@ -4,6 +4,7 @@
 
 #include "engine.h"
 #include "analyzer/scannerName.h"
+#include "mapGen/attributes.h"
 #include "mapGen/configuration.h"
 
 extern Configuration Config;
@@ -32,6 +33,39 @@ public:
 		return true;
 	};
 
+	/**
+	 * @brief If levelMatches() only looks at the level seed, Spawn, StairsDown and POI
+	 *
+	 * A level from the level cache can then be used instead of generating it.
+	 */
+	virtual bool usesLevelFeaturesOnly()
+	{
+		return false;
+	};
+
+	/**
+	 * @brief Levels that may be generated in any order
+	 *
+	 * Each of these levels must only depend on the game seed, must not report anything
+	 * and a mismatch on any of them must reject the seed.
+	 * @return Bit mask of levels
+	 */
+	virtual uint32_t independentLevels()
+	{
+		return 0;
+	};
+
+	/**
+	 * @brief Report a match for the current game seed and level
+	 * @param levelSeed Level seed to include in the result
+	 * @param metric Scanner specific value to include in the result
+	 */
+	static void report(std::optional<uint32_t> levelSeed = std::nullopt, int32_t metric = 0);
+	/**
+	 * @brief Record a metric of the current level for --attributes
+	 */
+	static void recordAttribute(Attribute attribute, int32_t value);
+
 	virtual ~Scanner()
 	{
 	}
@@ -4,6 +4,8 @@
  * Implementation of general dungeon generation code.
  */
 #include "all.h"
+#include "mapGen/floodFill.h"
+#include "mapGen/levelType.h"
 
 /** Contains the tile IDs of the map. */
 BYTE dungeon[DMAXX][DMAXY];
@@ -113,15 +115,22 @@ char TransVal;
 /** Specifies the active transparency indices. */
 BOOLEAN TransList[256];
 /** Contains the piece IDs of each tile on the map. */
+#ifdef GENERATION_ONLY
+WORD dPiece[MAXDUNX][MAXDUNY];
+static_assert(MAXTILES <= 0xFFFF, "Piece IDs must fit in dPiece");
+#else
 int dPiece[MAXDUNX][MAXDUNY];
 /** Specifies the dungeon piece information for a given coordinate and block number. */
 MICROS dpiece_defs_map_2[MAXDUNX][MAXDUNY];
 /** Specifies the dungeon piece information for a given coordinate and block number, optimized for diagonal access. */
 MICROS dpiece_defs_map_1[MAXDUNX * MAXDUNY];
+#endif
 /** Specifies the transparency at each coordinate of the map. */
 char dTransVal[MAXDUNX][MAXDUNY];
+#ifndef GENERATION_ONLY
 char dLight[MAXDUNX][MAXDUNY];
 char dPreLight[MAXDUNX][MAXDUNY];
+#endif
 char dFlags[MAXDUNX][MAXDUNY];
 /** Contains the player numbers (players array indices) of the map. */
 char dPlayer[MAXDUNX][MAXDUNY];
@@ -130,6 +139,10 @@ char dPlayer[MAXDUNX][MAXDUNY];
  * towner number (towners array index) in Tristram and a monster number
  * (monsters array index) in the dungeon.
  */
+#ifdef GENERATION_ONLY
+BYTE dMonster[MAXDUNX][MAXDUNY];
+static_assert(MAXMONSTERS <= 0xFF, "Monster numbers must fit in dMonster");
+#else
 int dMonster[MAXDUNX][MAXDUNY];
 /**
  * Contains the dead numbers (deads array indices) and dead direction of
@@ -138,10 +151,12 @@ int dMonster[MAXDUNX][MAXDUNY];
  * dDead[x][y] >> 0x5 - direction
  */
 char dDead[MAXDUNX][MAXDUNY];
+#endif
 /** Contains the object numbers (objects array indices) of the map. */
 char dObject[MAXDUNX][MAXDUNY];
 /** Contains the item numbers (items array indices) of the map. */
 char dItem[MAXDUNX][MAXDUNY];
+#ifndef GENERATION_ONLY
 /** Contains the missile numbers (missiles array indices) of the map. */
 char dMissile[MAXDUNX][MAXDUNY];
 /**
@@ -150,6 +165,8 @@ char dMissile[MAXDUNX][MAXDUNY];
  * "levels/towndata/towns.cel") contains trees rather than arches.
  */
 char dSpecial[MAXDUNX][MAXDUNY];
+#endif
+BYTE dirtyGrids;
 int themeCount;
 THEME_LOC themeLoc[MAXTHEMES];
 
@@ -224,6 +241,75 @@ void FillSolidBlockTbls()
 	mem_free_dbg(pSBFile);
 }
 
+/** Type of the entries of dPiece, and of two vertically adjacent entries with the top one first */
+#ifdef GENERATION_ONLY
+typedef WORD PieceId;
+typedef uint32_t PiecePair;
+#else
+typedef int PieceId;
+typedef uint64_t PiecePair;
+#endif
+static_assert(sizeof(PieceId) == sizeof(dPiece[0][0]) && sizeof(PiecePair) == 2 * sizeof(PieceId), "PiecePair must hold two dPiece entries");
+
+/**
+ * Piece IDs of the left and right columns of each megatile, indexed by dungeon tile ID.
+ * Tile 0 and tiles missing from the .TIL file have all pieces set to 0.
+ */
+static PiecePair megaTileColumns[2][256];
+
+/**
+ * @brief Widen the megatiles of the current level type for DRLG_ExpandMegaTiles
+ * @param dwTiles Size of pMegaTiles in bytes
+ */
+void FillMegaTileTbls(DWORD dwTiles)
+{
+	int i, side;
+	PieceId column[2];
+
+	memset(megaTileColumns, 0, sizeof(megaTileColumns));
+
+	for (i = 1; i < 256 && i * 8 <= dwTiles; i++) {
+		for (side = 0; side < 2; side++) {
+			column[0] = *((WORD *)&pMegaTiles[(i - 1) * 8] + side) + 1;
+			column[1] = *((WORD *)&pMegaTiles[(i - 1) * 8] + side + 2) + 1;
+			memcpy(&megaTileColumns[side][i], column, sizeof(column));
+		}
+	}
+}
+
+/**
+ * @brief Set dPiece to the megatiles of dungeon, surrounded by the fill megatile
+ *
+ * Dungeon tile (i, j) covers dPiece 2 * i + 16 to 2 * i + 17 and 2 * j + 16 to 2 * j + 17.
+ * The columns of dPiece are built in a buffer per side that keeps the fill megatile
+ * above and below the dungeon, and are copied over in one go.
+ */
+void DRLG_ExpandMegaTiles(BYTE fill)
+{
+	int x, i, j, side;
+	PiecePair column[2][MAXDUNY / 2];
+
+	for (side = 0; side < 2; side++) {
+		for (j = 0; j < MAXDUNY / 2; j++)
+			column[side][j] = megaTileColumns[side][fill];
+	}
+
+	for (x = 0; x < MAXDUNX; x++) {
+		side = x & 1;
+		i = x / 2 - 8;
+		if (i >= 0 && i < DMAXX) {
+			for (j = 0; j < DMAXY; j++)
+				column[side][8 + j] = megaTileColumns[side][dungeon[i][j]];
+		} else if (i == DMAXX) {
+			// Past the dungeon, back to the fill megatile
+			for (j = 0; j < DMAXY; j++)
+				column[side][8 + j] = megaTileColumns[side][fill];
+		}
+		memcpy(dPiece[x], column[side], sizeof(dPiece[x]));
+	}
+}
+
+#ifndef GENERATION_ONLY
 static void SwapTile(int f1, int f2)
 {
 	int swap;
@@ -599,6 +685,7 @@ void MakeSpeedCels()
 		}
 	}
 }
+#endif
 
 int IsometricCoord(int x, int y)
 {
@@ -610,6 +697,7 @@ int IsometricCoord(int x, int y)
 	return MAXDUNX * MAXDUNY - ((y + y * y + x * (x + 2 * y + 3)) / 2) - 1;
 }
 
+#ifndef GENERATION_ONLY
 void SetSpeedCels()
 {
 	int x, y;
@@ -669,6 +757,7 @@ void SetDungeonMicros()
 		ViewBY = ZOOM_HEIGHT / TILE_HEIGHT;
 	}
 }
+#endif
 
 void DRLG_InitTrans()
 {
@@ -695,6 +784,108 @@ void DRLG_MRectTrans(int x1, int y1, int x2, int y2)
 	TransVal++;
 }
 
+struct TransFloodNode {
+	int i;
+	int j;
+	int x;
+	int y;
+	/** Direction the tile was reached from, 0 for the first tile */
+	int d;
+	/** Next direction to visit from the tile */
+	int step;
+};
+
+/** Tile and dTransVal offsets of the neighbours, in the order they are visited */
+static const int TransFloodDirs[8][2] = {
+	// clang-format off
+	{  1,  0 },
+	{ -1,  0 },
+	{  0,  1 },
+	{  0, -1 },
+	{ -1, -1 },
+	{  1, -1 },
+	{ -1,  1 },
+	{  1,  1 },
+	// clang-format on
+};
+
+static FloodStep DRLG_TransFloodEnter(const TransFloodNode &node, BYTE floor)
+{
+	int x = node.x;
+	int y = node.y;
+
+	if (dTransVal[x][y] != 0 || GetDungeon(node.i, node.j) != floor) {
+		if (node.d == 1) {
+			dTransVal[x][y] = TransVal;
+			dTransVal[x][y + 1] = TransVal;
+		}
+		if (node.d == 2) {
+			dTransVal[x + 1][y] = TransVal;
+			dTransVal[x + 1][y + 1] = TransVal;
+		}
+		if (node.d == 3) {
+			dTransVal[x][y] = TransVal;
+			dTransVal[x + 1][y] = TransVal;
+		}
+		if (node.d == 4) {
+			dTransVal[x][y + 1] = TransVal;
+			dTransVal[x + 1][y + 1] = TransVal;
+		}
+		if (node.d == 5) {
+			dTransVal[x + 1][y + 1] = TransVal;
+		}
+		if (node.d == 6) {
+			dTransVal[x][y + 1] = TransVal;
+		}
+		if (node.d == 7) {
+			dTransVal[x + 1][y] = TransVal;
+		}
+		if (node.d == 8) {
+			dTransVal[x][y] = TransVal;
+		}
+		return FloodStep::Skip;
+	}
+
+	dTransVal[x][y] = TransVal;
+	dTransVal[x + 1][y] = TransVal;
+	dTransVal[x][y + 1] = TransVal;
+	dTransVal[x + 1][y + 1] = TransVal;
+	return FloodStep::Expand;
+}
+
+static bool DRLG_TransFloodNext(TransFloodNode &node, TransFloodNode &child)
+{
+	int dx, dy;
+
+	if (node.step == 8)
+		return false;
+
+	dx = TransFloodDirs[node.step][0];
+	dy = TransFloodDirs[node.step][1];
+	node.step++;
+	child = { node.i + dx, node.j + dy, node.x + 2 * dx, node.y + 2 * dy, node.step, 0 };
+	return true;
+}
+
+/**
+ * @brief Give the floor tiles connected to (i, j) the current TransVal
+ *
+ * The tiles are visited in the same order as the recursive fill of the original
+ * generators, so the walls around the area get the same values.
+ * @param i Tile x-coordinate
+ * @param j Tile y-coordinate
+ * @param x dTransVal x-coordinate of the tile
+ * @param y dTransVal y-coordinate of the tile
+ * @param floor Id of the floor tile of the level type
+ */
+void DRLG_FloodTransVal(int i, int j, int x, int y, BYTE floor)
+{
+	TransFloodNode root = { i, j, x, y, 0, 0 };
+	auto enter = [floor](const TransFloodNode &node) { return DRLG_TransFloodEnter(node, floor); };
+
+	OrderedFlood(root, enter, DRLG_TransFloodNext);
+}
+
 void DRLG_RectTrans(int x1, int y1, int x2, int y2)
 {
 	int i, j;
@@ -761,6 +952,7 @@ void DRLG_SetPC()
 	x = 2 * setpc_x + 16;
 	y = 2 * setpc_y + 16;
 
+	dirtyGrids |= DIRTY_FLAGS;
 	for (j = 0; j < h; j++) {
 		for (i = 0; i < w; i++) {
 			dFlags[i + x][j + y] |= BFLAG_POPULATED;
@@ -778,6 +970,7 @@ void Make_SetPC(int x, int y, int w, int h)
 	dx = 2 * x + 16;
 	dy = 2 * y + 16;
 
+	dirtyGrids |= DIRTY_FLAGS;
 	for (j = 0; j < dh; j++) {
 		for (i = 0; i < dw; i++) {
 			dFlags[i + dx][j + dy] |= BFLAG_POPULATED;
@@ -785,6 +978,63 @@ void Make_SetPC(int x, int y, int w, int h)
 	}
 }
 
+namespace {
+
+/**
+ * Number of consecutive floor tiles starting at each tile, indexed by x * DMAXY + y the
+ * way GetDungeon() flattens out of range positions, so a run can continue into the next
+ * column. Only valid for the dungeon as it was when the runs were built.
+ */
+struct FloorRuns {
+	/** Floor tiles at x, x + 1, ... */
+	WORD right[DMAXX * DMAXY];
+	/** Floor tiles at y, y + 1, ... */
+	WORD down[DMAXX * DMAXY];
+	int floor;
+	bool valid;
+};
+
+FloorRuns themeRuns;
+
+void BuildFloorRuns(int floor)
+{
+	const BYTE *tiles = &dungeon[0][0];
+	int i, k;
+
+	for (k = (DMAXX - 1) * DMAXY; k < DMAXX * DMAXY; k++)
+		themeRuns.right[k] = tiles[k] == floor ? 1 : 0;
+	// Each column only depends on the next one, so the inner loop vectorizes
+	for (i = DMAXX - 2; i >= 0; i--) {
+		for (k = i * DMAXY; k < (i + 1) * DMAXY; k++)
+			themeRuns.right[k] = tiles[k] == floor ? themeRuns.right[k + DMAXY] + 1 : 0;
+	}
+
+	themeRuns.down[DMAXX * DMAXY - 1] = tiles[DMAXX * DMAXY - 1] == floor ? 1 : 0;
+	for (k = DMAXX * DMAXY - 2; k >= 0; k--)
+		themeRuns.down[k] = tiles[k] == floor ? themeRuns.down[k + 1] + 1 : 0;
+
+	themeRuns.floor = floor;
+	themeRuns.valid = true;
+}
+
+int FloorRun(const WORD *runs, int k)
+{
+	if (k >= DMAXX * DMAXY)
+		return 0;
+	return runs[k];
+}
+
+/**
+ * @brief Account for reading the tile that ended a run, like GetDungeon() would
+ */
+void ReadRunEnd(int k)
+{
+	if (k >= DMAXX * DMAXY)
+		oobread = true;
+}
+
+}  // namespace
+
 BOOL DRLG_WillThemeRoomFit(int floor, int x, int y, int minSize, int maxSize, int *width, int *height)
 {
 	int ii, xx, yy;
@@ -809,38 +1059,42 @@ BOOL DRLG_WillThemeRoomFit(int floor, int x, int y, int minSize, int maxSize, in
 	memset(xArray, 0, sizeof(xArray));
 	memset(yArray, 0, sizeof(yArray));
 
+	if (!themeRuns.valid || themeRuns.floor != floor)
+		BuildFloorRuns(floor);
+
 	for (ii = 0; ii < maxSize; ii++) {
 		if (xFlag) {
-			for (xx = x; xx < x + maxSize; xx++) {
-				if (GetDungeon(xx, y + ii) != floor) {
-					if (xx >= minSize) { // BUGFIX: This is comparing absolute to relative, should be `xx - x >= minSize`
+			xCount = FloorRun(themeRuns.right, x * DMAXY + y + ii);
+			xx = x + xCount;
+			if (xCount >= maxSize) {
+				xArray[ii] = maxSize;
+			} else if (xx >= minSize) { // BUGFIX: This is comparing absolute to relative, should be `xx - x >= minSize`
+				ReadRunEnd(xx * DMAXY + y + ii);
+				xArray[ii] = xCount;
+			} else {
+				// The row is rejected but the original scan keeps reading until the end of it
+				xFlag = FALSE;
+				for (xx++; xx < x + maxSize; xx++) {
+					if (GetDungeon(xx, y + ii) != floor && xx >= minSize)
 						break;
-					}
-					xFlag = FALSE;
-				} else {
-					xCount++;
 				}
 			}
-			if (xFlag) {
-				xArray[ii] = xCount;
-				xCount = 0;
-			}
 		}
 		if (yFlag) {
-			for (yy = y; yy < y + maxSize; yy++) {
-				if (GetDungeon(x + ii, yy) != floor) {
-					if (yy >= minSize) { // BUGFIX: This is comparing absolute to relative, should be `yy - y >= minSize`
+			yCount = FloorRun(themeRuns.down, (x + ii) * DMAXY + y);
+			yy = y + yCount;
+			if (yCount >= maxSize) {
+				yArray[ii] = maxSize;
+			} else if (yy >= minSize) { // BUGFIX: This is comparing absolute to relative, should be `yy - y >= minSize`
+				ReadRunEnd((x + ii) * DMAXY + yy);
+				yArray[ii] = yCount;
+			} else {
+				yFlag = FALSE;
+				for (yy++; yy < y + maxSize; yy++) {
+					if (GetDungeon(x + ii, yy) != floor && yy >= minSize)
 						break;
-					}
-					yFlag = FALSE;
-				} else {
-					yCount++;
 				}
 			}
-			if (yFlag) {
-				yArray[ii] = yCount;
-				yCount = 0;
-			}
 		}
 	}
 
@@ -870,13 +1124,16 @@ BOOL DRLG_WillThemeRoomFit(int floor, int x, int y, int minSize, int maxSize, in
 	return TRUE;
 }
 
-void DRLG_CreateThemeRoom(int themeIndex)
+namespace {
+
+template <int LevelType>
+void CreateThemeRoom(int themeIndex)
 {
 	int xx, yy;
 
 	for (yy = themeLoc[themeIndex].y; yy < themeLoc[themeIndex].y + themeLoc[themeIndex].height; yy++) {
 		for (xx = themeLoc[themeIndex].x; xx < themeLoc[themeIndex].x + themeLoc[themeIndex].width; xx++) {
-			if (leveltype == DTYPE_CATACOMBS) {
+			if constexpr (LevelType == DTYPE_CATACOMBS) {
 				if (yy == themeLoc[themeIndex].y
 				        && xx >= themeLoc[themeIndex].x
 				        && xx <= themeLoc[themeIndex].x + themeLoc[themeIndex].width
@@ -895,7 +1152,7 @@ void DRLG_CreateThemeRoom(int themeIndex)
 					SetDungeon(xx, yy, 3);
 				}
 			}
-			if (leveltype == DTYPE_CAVES) {
+			if constexpr (LevelType == DTYPE_CAVES) {
 				if (yy == themeLoc[themeIndex].y
 				        && xx >= themeLoc[themeIndex].x
 				        && xx <= themeLoc[themeIndex].x + themeLoc[themeIndex].width
@@ -914,7 +1171,7 @@ void DRLG_CreateThemeRoom(int themeIndex)
 					SetDungeon(xx, yy, 7);
 				}
 			}
-			if (leveltype == DTYPE_HELL) {
+			if constexpr (LevelType == DTYPE_HELL) {
 				if (yy == themeLoc[themeIndex].y
 				        && xx >= themeLoc[themeIndex].x
 				        && xx <= themeLoc[themeIndex].x + themeLoc[themeIndex].width
@@ -936,26 +1193,26 @@ void DRLG_CreateThemeRoom(int themeIndex)
 		}
 	}
 
-	if (leveltype == DTYPE_CATACOMBS) {
+	if constexpr (LevelType == DTYPE_CATACOMBS) {
 		SetDungeon(themeLoc[themeIndex].x, themeLoc[themeIndex].y, 8);
 		SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y, 7);
 		SetDungeon(themeLoc[themeIndex].x, themeLoc[themeIndex].y + themeLoc[themeIndex].height - 1, 9);
 		SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y + themeLoc[themeIndex].height - 1, 6);
 	}
-	if (leveltype == DTYPE_CAVES) {
+	if constexpr (LevelType == DTYPE_CAVES) {
 		SetDungeon(themeLoc[themeIndex].x, themeLoc[themeIndex].y, 150);
 		SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y, 151);
 		SetDungeon(themeLoc[themeIndex].x, themeLoc[themeIndex].y + themeLoc[themeIndex].height - 1, 152);
 		SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y + themeLoc[themeIndex].height - 1, 138);
 	}
-	if (leveltype == DTYPE_HELL) {
+	if constexpr (LevelType == DTYPE_HELL) {
 		SetDungeon(themeLoc[themeIndex].x, themeLoc[themeIndex].y, 9);
 		SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y, 16);
 		SetDungeon(themeLoc[themeIndex].x, themeLoc[themeIndex].y + themeLoc[themeIndex].height - 1, 15);
 		SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y + themeLoc[themeIndex].height - 1, 12);
 	}
 
-	if (leveltype == DTYPE_CATACOMBS) {
+	if constexpr (LevelType == DTYPE_CATACOMBS) {
 		switch (random_(0, 2)) {
 		case 0:
 			SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y + themeLoc[themeIndex].height / 2, 4);
@@ -965,7 +1222,7 @@ void DRLG_CreateThemeRoom(int themeIndex)
 			break;
 		}
 	}
-	if (leveltype == DTYPE_CAVES) {
+	if constexpr (LevelType == DTYPE_CAVES) {
 		switch (random_(0, 2)) {
 		case 0:
 			SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y + themeLoc[themeIndex].height / 2, 147);
@@ -975,7 +1232,7 @@ void DRLG_CreateThemeRoom(int themeIndex)
 			break;
 		}
 	}
-	if (leveltype == DTYPE_HELL) {
+	if constexpr (LevelType == DTYPE_HELL) {
 		switch (random_(0, 2)) {
 		case 0:
 			SetDungeon(themeLoc[themeIndex].x + themeLoc[themeIndex].width - 1, themeLoc[themeIndex].y + themeLoc[themeIndex].height / 2 - 1, 53);
@@ -994,6 +1251,15 @@ void DRLG_CreateThemeRoom(int themeIndex)
 	}
 }
 
+}  // namespace
+
+void DRLG_CreateThemeRoom(int themeIndex)
+{
+	DispatchLevelType([themeIndex](auto levelType) {
+		CreateThemeRoom<decltype(levelType)::value>(themeIndex);
+	});
+}
+
 void DRLG_PlaceThemeRooms(int minSize, int maxSize, int floor, int freq, int rndSize)
 {
 	int i, j;
@@ -1002,6 +1268,7 @@ void DRLG_PlaceThemeRooms(int minSize, int maxSize, int floor, int freq, int rnd
 
 	themeCount = 0;
 	memset(themeLoc, 0, sizeof(*themeLoc));
+	themeRuns.valid = false;
 	for (j = 0; j < DMAXY; j++) {
 		for (i = 0; i < DMAXX; i++) {
 			if (dungeon[i][j] == floor && !random_(0, freq) && DRLG_WillThemeRoomFit(floor, i, j, minSize, maxSize, &themeW, &themeH)) {
@@ -1029,6 +1296,7 @@ void DRLG_PlaceThemeRooms(int minSize, int maxSize, int floor, int freq, int rnd
 					DRLG_MRectTrans(i + 1, j + 1, i + themeW, j + themeH);
 				themeLoc[themeCount].ttval = TransVal - 1;
 				DRLG_CreateThemeRoom(themeCount);
+				themeRuns.valid = false;
 				themeCount++;
 			}
 		}
@@ -1040,6 +1308,7 @@ void DRLG_HoldThemeRooms()
 {
 	int i, x, y, xx, yy;
 
+	dirtyGrids |= DIRTY_FLAGS;
 	for (i = 0; i < themeCount; i++) {
 		for (y = themeLoc[i].y; y < themeLoc[i].y + themeLoc[i].height - 1; y++) {
 			for (x = themeLoc[i].x; x < themeLoc[i].x + themeLoc[i].width - 1; x++) {
@@ -49,28 +49,53 @@ extern int LvlViewY;
 extern int MicroTileLen;
 extern char TransVal;
 extern BOOLEAN TransList[256];
+#ifdef GENERATION_ONLY
+extern WORD dPiece[MAXDUNX][MAXDUNY];
+#else
 extern int dPiece[MAXDUNX][MAXDUNY];
 extern MICROS dpiece_defs_map_2[MAXDUNX][MAXDUNY];
 extern MICROS dpiece_defs_map_1[MAXDUNX * MAXDUNY];
+#endif
 extern char dTransVal[MAXDUNX][MAXDUNY];
+#ifndef GENERATION_ONLY
 extern char dLight[MAXDUNX][MAXDUNY];
 extern char dPreLight[MAXDUNX][MAXDUNY];
+#endif
 extern char dFlags[MAXDUNX][MAXDUNY];
 extern char dPlayer[MAXDUNX][MAXDUNY];
+#ifdef GENERATION_ONLY
+extern BYTE dMonster[MAXDUNX][MAXDUNY];
+#else
 extern int dMonster[MAXDUNX][MAXDUNY];
 extern char dDead[MAXDUNX][MAXDUNY];
+#endif
 extern char dObject[MAXDUNX][MAXDUNY];
 extern char dItem[MAXDUNX][MAXDUNY];
+#ifndef GENERATION_ONLY
 extern char dMissile[MAXDUNX][MAXDUNY];
 extern char dSpecial[MAXDUNX][MAXDUNY];
+#endif
+/** Grids that may still hold data from the previous level, DRLG_Init_Globals only clears these */
+enum dirty_grid : BYTE {
+	DIRTY_FLAGS = 1 << 0,
+	DIRTY_MONSTER = 1 << 1,
+	DIRTY_OBJECT = 1 << 2,
+	DIRTY_ITEM = 1 << 3,
+};
+extern BYTE dirtyGrids;
 extern int themeCount;
 extern THEME_LOC themeLoc[MAXTHEMES];
 
 void FillSolidBlockTbls();
+void FillMegaTileTbls(DWORD dwTiles);
+void DRLG_ExpandMegaTiles(BYTE fill);
 int IsometricCoord(int x, int y);
+#ifndef GENERATION_ONLY
 void SetDungeonMicros();
+#endif
 void DRLG_InitTrans();
 void DRLG_MRectTrans(int x1, int y1, int x2, int y2);
+void DRLG_FloodTransVal(int i, int j, int x, int y, BYTE floor);
 void DRLG_RectTrans(int x1, int y1, int x2, int y2);
 void DRLG_CopyTrans(int sx, int sy, int dx, int dy);
 void DRLG_ListTrans(int num, BYTE *List);
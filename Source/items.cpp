@@ -369,6 +369,7 @@ void AddInitItems()
 		item[i]._ix = x;
 		item[i]._iy = y;
 		dItem[x][y] = i + 1;
+		dirtyGrids |= DIRTY_ITEM;
 		item[i]._iSeed = GetRndSeed();
 		SetRndSeed(item[i]._iSeed);
 #ifdef HELLFIRE
@@ -574,6 +575,7 @@ BOOL GetItemSpace(int x, int y, char inum)
 	item[inum]._ix = xx;
 	item[inum]._iy = yy;
 	dItem[xx][yy] = inum + 1;
+	dirtyGrids |= DIRTY_ITEM;
 
 	return TRUE;
 }
@@ -593,6 +595,7 @@ void GetSuperItemSpace(int x, int y, char inum)
 						item[inum]._ix = xx;
 						item[inum]._iy = yy;
 						dItem[xx][yy] = inum + 1;
+						dirtyGrids |= DIRTY_ITEM;
 						return;
 					}
 				}
@@ -2047,6 +2050,7 @@ void SpawnQuestItem(int itemid, int x, int y, int randarea, int selflag)
 		item[i]._ix = x;
 		item[i]._iy = y;
 		dItem[x][y] = i + 1;
+		dirtyGrids |= DIRTY_ITEM;
 #ifdef HELLFIRE
 		GetItemAttrs(i, itemid, curlv);
 #else
@@ -2086,6 +2090,7 @@ void SpawnRock()
 		item[i]._ix = xx;
 		item[i]._iy = yy;
 		dItem[xx][item[i]._iy] = i + 1;
+		dirtyGrids |= DIRTY_ITEM;
 #ifdef HELLFIRE
 		GetItemAttrs(i, IDI_ROCK, curlv);
 #else
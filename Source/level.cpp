@@ -4,6 +4,8 @@
 #include <iostream>
 #include <stdio.h>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -18,31 +20,91 @@
 #include "objdat.h"
 #include "objects.h"
 
-inline void WriteLE16(FILE *out, uint16_t val)
-{
-	fwrite(&val, 1, 2, out);
-}
+namespace {
 
-void ExportDun(uint32_t seed)
-{
-	char fileName[32];
-	sprintf(fileName, "%u-%u-%u.dun", seed, currlevel, glSeedTbl[currlevel]);
-	FILE *dunFile = fopen(fileName, "wb");
+/** Number of entries in MonstConvTbl that can be referenced from a .dun */
+constexpr int MonsterConvCount = 128;
+/** Number of entries in ObjTypeConv that can be referenced from a .dun */
+constexpr int ObjectConvCount = 139;
+
+constexpr char DunArchiveMagic[4] = { 'D', 'U', 'N', 'A' };
+
+/** Size of an exported .dun: dimensions, tiles, and four 80x80 layers */
+constexpr size_t DunSize = 2 * (2 + DMAXX * DMAXY + 4 * (MAXDUNX - 32) * (MAXDUNY - 32));
+
+/** Inverse of MonstConvTbl and ObjTypeConv, the first matching .dun id wins */
+struct DunIdTables {
+	uint16_t monsterIds[256] = {};
+	uint16_t objectIds[256] = {};
+
+	DunIdTables()
+	{
+		bool monsterSet[256] = {};
+		for (int i = 0; i < MonsterConvCount; i++) {
+			uint8_t mtype = MonstConvTbl[i];
+			if (monsterSet[mtype])
+				continue;
+			monsterSet[mtype] = true;
+			monsterIds[mtype] = i + 1;
+		}
+
+		bool objectSet[256] = {};
+		for (int i = 0; i < ObjectConvCount; i++) {
+			uint8_t otype = ObjTypeConv[i];
+			if (objectSet[otype])
+				continue;
+			objectSet[otype] = true;
+			objectIds[otype] = i;
+		}
+	}
+};
+
+const DunIdTables DunIds;
+
+class DunBuffer {
+public:
+	void WriteLE16(uint16_t val)
+	{
+		data[size++] = val & 0xFF;
+		data[size++] = val >> 8;
+	}
+
+	void Reset()
+	{
+		size = 0;
+	}
+
+	const uint8_t *Data() const
+	{
+		return data;
+	}
+
+	size_t Size() const
+	{
+		return size;
+	}
 
-	WriteLE16(dunFile, DMAXX);
-	WriteLE16(dunFile, DMAXY);
+private:
+	uint8_t data[DunSize];
+	size_t size = 0;
+};
+
+void WriteDun(DunBuffer &dun)
+{
+	dun.WriteLE16(DMAXX);
+	dun.WriteLE16(DMAXY);
 
 	/** Tiles. */
 	for (int y = 0; y < DMAXY; y++) {
 		for (int x = 0; x < DMAXX; x++) {
-			WriteLE16(dunFile, dungeon[x][y]);
+			dun.WriteLE16(dungeon[x][y]);
 		}
 	}
 
 	/** Padding */
 	for (int y = 16; y < MAXDUNY - 16; y++) {
 		for (int x = 16; x < MAXDUNX - 16; x++) {
-			WriteLE16(dunFile, 0);
+			dun.WriteLE16(0);
 		}
 	}
 
@@ -50,15 +112,9 @@ void ExportDun(uint32_t seed)
 	for (int y = 16; y < MAXDUNY - 16; y++) {
 		for (int x = 16; x < MAXDUNX - 16; x++) {
 			uint16_t monsterId = 0;
-			if (dMonster[x][y] > 0) {
-				for (int i = 0; i < 128; i++) {
-					if (MonstConvTbl[i] == monster[dMonster[x][y] - 1].MType->mtype) {
-						monsterId = i + 1;
-						break;
-					}
-				}
-			}
-			WriteLE16(dunFile, monsterId);
+			if (dMonster[x][y] > 0)
+				monsterId = DunIds.monsterIds[(uint8_t)monster[dMonster[x][y] - 1].MType->mtype];
+			dun.WriteLE16(monsterId);
 		}
 	}
 
@@ -66,86 +122,180 @@ void ExportDun(uint32_t seed)
 	for (int y = 16; y < MAXDUNY - 16; y++) {
 		for (int x = 16; x < MAXDUNX - 16; x++) {
 			uint16_t objectId = 0;
-			if (dObject[x][y] > 0) {
-				for (int i = 0; i < 139; i++) {
-					if (ObjTypeConv[i] == object[dObject[x][y] - 1]._otype) {
-						objectId = i;
-						break;
-					}
-				}
-			}
-			WriteLE16(dunFile, objectId);
+			if (dObject[x][y] > 0)
+				objectId = DunIds.objectIds[(uint8_t)object[dObject[x][y] - 1]._otype];
+			dun.WriteLE16(objectId);
 		}
 	}
 
 	/** Transparency */
 	for (int y = 16; y < MAXDUNY - 16; y++) {
 		for (int x = 16; x < MAXDUNX - 16; x++) {
-			WriteLE16(dunFile, dTransVal[x][y]);
+			dun.WriteLE16(dTransVal[x][y]);
 		}
 	}
-	fclose(dunFile);
 }
 
-std::string red(std::string text)
-{
-#ifdef _WIN32
-	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_RED);
-	return text;
-#else
-	return "\033[0;31m" + text + "\033[0m";
-#endif
-}
+struct DunArchiveEntry {
+	uint32_t gameSeed;
+	uint32_t level;
+	uint32_t dungeonSeed;
+	uint32_t size;
+	uint64_t offset;
+};
+
+FILE *dunArchive;
+uint64_t dunArchiveOffset;
+std::vector<DunArchiveEntry> dunArchiveIndex;
 
-std::string green(std::string text)
+void WriteToArchive(uint32_t seed, const DunBuffer &dun)
 {
-#ifdef _WIN32
-	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_GREEN);
-	return text;
-#else
-	return "\033[1;32m" + text + "\033[0m";
-#endif
+	if (dunArchive == nullptr) {
+		dunArchive = fopen(Config.exportArchive.c_str(), "wb");
+		if (dunArchive == nullptr) {
+			std::cerr << "Unable to create archive: " << Config.exportArchive << std::endl;
+			exit(255);
+		}
+		fwrite(DunArchiveMagic, 1, sizeof(DunArchiveMagic), dunArchive);
+		dunArchiveOffset = sizeof(DunArchiveMagic);
+	}
+
+	dunArchiveIndex.push_back({ seed, currlevel, glSeedTbl[currlevel], (uint32_t)dun.Size(), dunArchiveOffset });
+	fwrite(dun.Data(), 1, dun.Size(), dunArchive);
+	dunArchiveOffset += dun.Size();
 }
 
-std::string yellow(std::string text)
+}  // namespace
+
+void ExportDun(uint32_t seed)
 {
-#ifdef _WIN32
-	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_RED | FOREGROUND_GREEN);
-	return text;
-#else
-	return "\033[1;33m" + text + "\033[0m";
-#endif
+	static DunBuffer dun;
+	dun.Reset();
+	WriteDun(dun);
+
+	if (!Config.exportArchive.empty()) {
+		WriteToArchive(seed, dun);
+		return;
+	}
+
+	char fileName[32];
+	sprintf(fileName, "%u-%u-%u.dun", seed, currlevel, glSeedTbl[currlevel]);
+	FILE *dunFile = fopen(fileName, "wb");
+	fwrite(dun.Data(), 1, dun.Size(), dunFile);
+	fclose(dunFile);
 }
 
-std::string gray(std::string text)
+/**
+ * @brief Write the index of the exported levels and close the archive
+ *
+ * The index is a list of entries (game seed, level, dungeon seed, size, offset) followed by
+ * the offset of the index and the number of entries, all little-endian.
+ */
+void CloseDunArchive()
 {
-#ifdef _WIN32
-	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
-	return text;
-#else
-	return "\033[0;90m" + text + "\033[0m";
-#endif
+	if (dunArchive == nullptr)
+		return;
+
+	uint64_t indexOffset = dunArchiveOffset;
+	for (const DunArchiveEntry &entry : dunArchiveIndex)
+		fwrite(&entry, 1, sizeof(entry), dunArchive);
+	uint32_t count = dunArchiveIndex.size();
+	fwrite(&indexOffset, 1, sizeof(indexOffset), dunArchive);
+	fwrite(&count, 1, sizeof(count), dunArchive);
+	fclose(dunArchive);
+
+	dunArchive = nullptr;
+	dunArchiveIndex.clear();
 }
 
-std::string cyan(std::string text)
-{
+namespace {
+
+enum class AsciiColor : uint8_t {
+	None,
+	Red,
+	Green,
+	Yellow,
+	Gray,
+	Cyan,
+};
+
+constexpr std::string_view AsciiColorCodes[] = {
+	"\033[0m",
+	"\033[0;31m",
+	"\033[1;32m",
+	"\033[1;33m",
+	"\033[0;90m",
+	"\033[0;36m",
+};
+
+constexpr int AsciiMin = 16;
+constexpr int AsciiMax = MAXDUNX - 17;
+constexpr int AsciiSize = AsciiMax - AsciiMin;
+/** Worst case is a color change on every cell plus a reset at the end of each row */
+constexpr size_t AsciiBufferSize = AsciiSize * (AsciiSize * 8 + 5) + 1;
+
+class AsciiBuffer {
+public:
+	AsciiBuffer(bool plain)
+	    : plain(plain)
+	{
+	}
+
+	void Put(char c, AsciiColor color = AsciiColor::None)
+	{
+		SetColor(color);
+		data[size++] = c;
+	}
+
+	void EndRow()
+	{
+		SetColor(AsciiColor::None);
+		data[size++] = '\n';
+	}
+
+	void Flush()
+	{
+		fwrite(data, 1, size, stdout);
+		size = 0;
+	}
+
+private:
+	void SetColor(AsciiColor color)
+	{
+		if (plain || color == current)
+			return;
+		current = color;
+		std::string_view code = AsciiColorCodes[static_cast<int>(color)];
+		memcpy(&data[size], code.data(), code.size());
+		size += code.size();
+	}
+
+	bool plain;
+	AsciiColor current = AsciiColor::None;
+	char data[AsciiBufferSize];
+	size_t size = 0;
+};
+
 #ifdef _WIN32
-	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_GREEN | FOREGROUND_BLUE);
-	return text;
-#else
-	return "\033[0;36m" + text + "\033[0m";
-#endif
+void EnableAnsiColors()
+{
+	static bool enabled = false;
+	if (enabled)
+		return;
+	enabled = true;
+
+	HANDLE console = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD mode = 0;
+	if (GetConsoleMode(console, &mode))
+		SetConsoleMode(console, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
 }
+#endif
+
+}  // namespace
 
 void printAsciiLevel()
 {
-	bool steps[MAXDUNX][MAXDUNY];
-
-	for (int i = 0; i < MAXDUNY; ++i) {
-		for (int j = 0; j < MAXDUNX; ++j) {
-			steps[i][j] = false;
-		}
-	}
+	bool steps[MAXDUNX][MAXDUNY] = {};
 
 	Point position = Spawn;
 	steps[position.x][position.y] = true;
@@ -161,32 +311,36 @@ void printAsciiLevel()
 		steps[position.x][position.y] = true;
 	}
 
-	for (int boby = 16; boby < MAXDUNY - 17; boby++) {
-		for (int bobx = 16; bobx < MAXDUNX - 17; bobx++) {
+#ifdef _WIN32
+	if (!Config.plainAscii)
+		EnableAnsiColors();
+#endif
+
+	static AsciiBuffer buffer(Config.plainAscii);
+
+	for (int boby = AsciiMin; boby < AsciiMax; boby++) {
+		for (int bobx = AsciiMin; bobx < AsciiMax; bobx++) {
 			if (Point { bobx, boby } == Spawn)
-				std::cout << red("^");
+				buffer.Put('^', AsciiColor::Red);
 			else if (Point { bobx, boby } == StairsDown)
-				std::cout << green("v");
+				buffer.Put('v', AsciiColor::Green);
 			else if (dObject[bobx][boby] && nSolidTable[dPiece[bobx][boby]])
-				std::cout << yellow("#");
+				buffer.Put('#', AsciiColor::Yellow);
 			else if (dMonster[bobx][boby])
-				std::cout << red("m");
+				buffer.Put('m', AsciiColor::Red);
 			else if (Point { bobx, boby } == POI && !nSolidTable[dPiece[bobx][boby]])
-				std::cout << red("!");
+				buffer.Put('!', AsciiColor::Red);
 			else if (dObject[bobx][boby])
-				std::cout << yellow("*");
+				buffer.Put('*', AsciiColor::Yellow);
 			else if (steps[bobx][boby])
-				std::cout << cyan("=");
+				buffer.Put('=', AsciiColor::Cyan);
 			else if (nSolidTable[dPiece[bobx][boby]])
-				std::cout << gray("#");
+				buffer.Put('#', AsciiColor::Gray);
 			else
-				std::cout << " ";
+				buffer.Put(' ');
 		}
-		std::cout << std::endl;
+		buffer.EndRow();
 	}
-	std::cout << std::endl;
-
-#ifdef _WIN32
-	SetConsoleTextAttribute(GetStdHandle(STD_OUTPUT_HANDLE), FOREGROUND_RED | FOREGROUND_GREEN | FOREGROUND_BLUE);
-#endif
+	buffer.Put('\n');
+	buffer.Flush();
 }
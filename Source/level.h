@@ -2,4 +2,5 @@
 #include "engine.h"
 
 void ExportDun(uint32_t seed);
+void CloseDunArchive();
 void printAsciiLevel();
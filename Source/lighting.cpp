@@ -5,6 +5,9 @@
  */
 #include "all.h"
 
+#include <algorithm>
+#include <bit>
+
 LightListStruct VisionList[MAXVISION];
 BYTE lightactive[MAXLIGHTS];
 LightListStruct LightList[MAXLIGHTS];
@@ -102,6 +105,7 @@ void DoLighting(int nXPos, int nYPos, int nRadius, int Lnum)
 
 void DoUnLight(int nXPos, int nYPos, int nRadius)
 {
+#ifndef GENERATION_ONLY
 	int x, y, min_x, min_y, max_x, max_y;
 
 	nRadius++;
@@ -131,6 +135,7 @@ void DoUnLight(int nXPos, int nYPos, int nRadius)
 				dLight[x][y] = dPreLight[x][y];
 		}
 	}
+#endif
 }
 
 void DoUnVision(int nXPos, int nYPos, int nRadius)
@@ -163,12 +168,34 @@ void DoUnVision(int nXPos, int nYPos, int nRadius)
 	}
 }
 
+/**
+ * @brief Same result as DoUnVision(x, y, nRadius) for every position of the 4x4 block
+ * from (nXPos - 2, nYPos - 2) to (nXPos + 1, nYPos + 1), as the areas overlap it is a single rectangle.
+ */
+void DoUnVisionBlock(int nXPos, int nYPos, int nRadius)
+{
+	int i, j, x1, y1, x2, y2;
+
+	nRadius++;
+	y1 = std::max(nYPos - 2 - nRadius, 0);
+	y2 = std::min(nYPos + 1 + nRadius, MAXDUNY);
+	x1 = std::max(nXPos - 2 - nRadius, 0);
+	x2 = std::min(nXPos + 1 + nRadius, MAXDUNX);
+
+	for (i = x1; i < x2; i++) {
+		for (j = y1; j < y2; j++) {
+			dFlags[i][j] &= ~(BFLAG_VISIBLE | BFLAG_LIT);
+		}
+	}
+}
+
 void DoVision(int nXPos, int nYPos, int nRadius, BOOL doautomap, BOOL visible)
 {
 	BOOL nBlockerFlag;
 	int nCrawlX, nCrawlY, nLineLen, nTrans;
 	int j, k, v, x1adj, x2adj, y1adj, y2adj;
 
+	dirtyGrids |= DIRTY_FLAGS;
 	if (nXPos >= 0 && nXPos <= MAXDUNX && nYPos >= 0 && nYPos <= MAXDUNY) { // BUGFIX < MAXDUNX/MAXDUNY or OOB
 		if (doautomap) {
 			if (dFlags[nXPos][nYPos] >= 0) {
@@ -252,6 +279,212 @@ void DoVision(int nXPos, int nYPos, int nRadius, BOOL doautomap, BOOL visible)
 	}
 }
 
+namespace {
+
+/** A step of a vision crawl and the two neighbours that both have to block for it to stay hidden */
+struct VisionStep {
+	int8_t x;
+	int8_t y;
+	int8_t adj1x;
+	int8_t adj1y;
+	int8_t adj2x;
+	int8_t adj2y;
+};
+
+/** Largest offset in vCrawlTable, so also the largest radius DoVisionBlock handles */
+constexpr int VisionCrawlMax = 15;
+/** Cells around the 4x4 block that a crawl and its neighbour probes can reach */
+constexpr int VisionBlockMargin = VisionCrawlMax + 1;
+constexpr int VisionBlockSize = 4 + 2 * VisionBlockMargin;
+static_assert(VisionBlockSize <= 64, "A row of the vision block must fit in a bit mask");
+
+/** vCrawlTable unrolled for each of the four quadrants, with the neighbour offsets DoVision uses */
+struct VisionSteps {
+	VisionStep steps[4][23][VisionCrawlMax];
+
+	VisionSteps()
+	{
+		for (int v = 0; v < 4; v++) {
+			for (int j = 0; j < 23; j++) {
+				for (int p = 0; p < VisionCrawlMax; p++) {
+					int x = vCrawlTable[j][2 * p];
+					int y = vCrawlTable[j][2 * p + 1];
+					bool diagonal = x > 0 && y > 0;
+					VisionStep &step = steps[v][j][p];
+					step = {};
+					switch (v) {
+					case 0:
+						step.x = x;
+						step.y = y;
+						if (diagonal) {
+							step.adj1x = -1;
+							step.adj2y = -1;
+						}
+						break;
+					case 1:
+						step.x = -x;
+						step.y = -y;
+						if (diagonal) {
+							step.adj1y = 1;
+							step.adj2x = 1;
+						}
+						break;
+					case 2:
+						step.x = x;
+						step.y = -y;
+						if (diagonal) {
+							step.adj1x = -1;
+							step.adj2y = 1;
+						}
+						break;
+					case 3:
+						step.x = -x;
+						step.y = y;
+						if (diagonal) {
+							step.adj1y = -1;
+							step.adj2x = 1;
+						}
+						break;
+					}
+				}
+			}
+		}
+	}
+};
+
+const VisionSteps &GetVisionSteps()
+{
+	static const VisionSteps visionSteps;
+	return visionSteps;
+}
+
+bool TestBit(const uint64_t *rows, int x, int y)
+{
+	return (rows[x] >> y) & 1;
+}
+
+/**
+ * @brief Crawl the vision rays of DoVision from (originX, originY) over a bit mask of the blocking tiles
+ */
+void CrawlVision(const uint64_t *blocked, uint64_t *crawled, int originX, int originY, int nRadius)
+{
+	const VisionSteps &visionSteps = GetVisionSteps();
+
+	for (int v = 0; v < 4; v++) {
+		for (int j = 0; j < 23; j++) {
+			int nLineLen = nRadius - RadiusAdj[j];
+			for (int p = 0; p < nLineLen; p++) {
+				const VisionStep &step = visionSteps.steps[v][j][p];
+				int x = originX + step.x;
+				int y = originY + step.y;
+				if (!TestBit(blocked, x + step.adj1x, y + step.adj1y) || !TestBit(blocked, x + step.adj2x, y + step.adj2y))
+					crawled[x] |= 1ULL << y;
+				if (TestBit(blocked, x, y))
+					break;
+			}
+		}
+	}
+}
+
+}
+
+/**
+ * @brief Same result as DoVision(x, y, nRadius, FALSE, FALSE) for every position of the 4x4 block
+ * from (nXPos - 2, nYPos - 2) to (nXPos + 1, nYPos + 1), but reads each tile's nBlockTable entry once
+ * and writes dFlags and TransList in a single pass.
+ */
+void DoVisionBlock(int nXPos, int nYPos, int nRadius)
+{
+	int minX = nXPos - 2 - VisionBlockMargin;
+	int minY = nYPos - 2 - VisionBlockMargin;
+	if (nRadius > VisionCrawlMax || minX < 0 || minY < 0 || minX + VisionBlockSize > MAXDUNX || minY + VisionBlockSize > MAXDUNY) {
+		// Close to the edge DoVision's out of bounds handling has to be reproduced
+		for (int s = -2; s < 2; s++) {
+			for (int t = -2; t < 2; t++)
+				DoVision(s + nXPos, t + nYPos, nRadius, FALSE, FALSE);
+		}
+		return;
+	}
+
+	dirtyGrids |= DIRTY_FLAGS;
+
+	uint64_t blocked[VisionBlockSize];
+	uint64_t visible[VisionBlockSize] = {};
+	uint64_t crawled[VisionBlockSize] = {};
+
+	for (int x = 0; x < VisionBlockSize; x++) {
+		uint64_t row = 0;
+		for (int y = 0; y < VisionBlockSize; y++) {
+			if (nBlockTable[dPiece[minX + x][minY + y]])
+				row |= 1ULL << y;
+		}
+		blocked[x] = row;
+	}
+
+	for (int s = 0; s < 4; s++) {
+		for (int t = 0; t < 4; t++) {
+			int originX = VisionBlockMargin + s;
+			int originY = VisionBlockMargin + t;
+			visible[originX] |= 1ULL << originY;
+			CrawlVision(blocked, crawled, originX, originY, nRadius);
+		}
+	}
+
+	for (int x = 0; x < VisionBlockSize; x++) {
+		for (uint64_t row = visible[x] | crawled[x]; row != 0; row &= row - 1)
+			dFlags[minX + x][minY + std::countr_zero(row)] |= BFLAG_VISIBLE;
+
+		for (uint64_t row = crawled[x] & ~blocked[x]; row != 0; row &= row - 1) {
+			int nTrans = dTransVal[minX + x][minY + std::countr_zero(row)];
+			if (nTrans != 0) {
+				TransList[nTrans] = TRUE;
+			}
+		}
+	}
+}
+
+/**
+ * @brief The tiles DoVision(nXPos, nYPos, nRadius, FALSE, FALSE) marks visible, bit y of mask[x] is the
+ * tile (nXPos - VISION_MASK_RADIUS + x, nYPos - VISION_MASK_RADIUS + y). Tiles outside the dungeon block
+ * the view and are never visible, and nRadius is capped at the longest crawl of vCrawlTable.
+ */
+void DoVisionMask(int nXPos, int nYPos, int nRadius, uint64_t (&mask)[VISION_MASK_SIZE])
+{
+	static_assert(VISION_MASK_RADIUS == VisionBlockMargin, "The vision mask must hold the crawls and their neighbour probes");
+
+	int minX = nXPos - VISION_MASK_RADIUS;
+	int minY = nYPos - VISION_MASK_RADIUS;
+	uint64_t inDungeon = 0;
+	for (int y = 0; y < VISION_MASK_SIZE; y++) {
+		if (minY + y >= 0 && minY + y < MAXDUNY)
+			inDungeon |= 1ULL << y;
+	}
+
+	uint64_t blocked[VISION_MASK_SIZE];
+	for (int x = 0; x < VISION_MASK_SIZE; x++) {
+		uint64_t row = ~inDungeon;
+		if (minX + x < 0 || minX + x >= MAXDUNX) {
+			blocked[x] = ~0ULL;
+			continue;
+		}
+		for (int y = 0; y < VISION_MASK_SIZE; y++) {
+			if (((inDungeon >> y) & 1) && nBlockTable[dPiece[minX + x][minY + y]])
+				row |= 1ULL << y;
+		}
+		blocked[x] = row;
+	}
+
+	memset(mask, 0, sizeof(mask));
+	mask[VISION_MASK_RADIUS] = 1ULL << VISION_MASK_RADIUS;
+	CrawlVision(blocked, mask, VISION_MASK_RADIUS, VISION_MASK_RADIUS, std::min(nRadius, VisionCrawlMax));
+
+	for (int x = 0; x < VISION_MASK_SIZE; x++) {
+		if (minX + x < 0 || minX + x >= MAXDUNX)
+			mask[x] = 0;
+		mask[x] &= inDungeon;
+	}
+}
+
 #ifdef _DEBUG
 void ToggleLighting_2()
 {
@@ -407,7 +640,9 @@ void ProcessLightList()
 
 void SavePreLighting()
 {
+#ifndef GENERATION_ONLY
 	memcpy(dPreLight, dLight, sizeof(dPreLight));
+#endif
 }
 
 void InitVision()
@@ -20,7 +20,10 @@ extern BOOL lightflag;
 
 void DoLighting(int nXPos, int nYPos, int nRadius, int Lnum);
 void DoUnVision(int nXPos, int nYPos, int nRadius);
+void DoUnVisionBlock(int nXPos, int nYPos, int nRadius);
 void DoVision(int nXPos, int nYPos, int nRadius, BOOL doautomap, BOOL visible);
+void DoVisionBlock(int nXPos, int nYPos, int nRadius);
+void DoVisionMask(int nXPos, int nYPos, int nRadius, uint64_t (&mask)[VISION_MASK_SIZE]);
 #ifdef _DEBUG
 void ToggleLighting_2();
 void ToggleLighting();
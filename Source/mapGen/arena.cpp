@@ -0,0 +1,60 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+/** Large enough for the biggest set piece, so a level normally fits in the first chunk */
+constexpr size_t ChunkSize = 64 * 1024;
+
+}  // namespace
+
+void *Arena::Allocate(size_t size, size_t align)
+{
+	while (true) {
+		if (current == chunks.size()) {
+			size_t chunkSize = std::max(ChunkSize, size + align);
+			chunks.push_back({ std::make_unique<std::byte[]>(chunkSize), chunkSize });
+		}
+
+		Chunk &chunk = chunks[current];
+		uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data.get());
+		size_t offset = ((base + used + align - 1) & ~(uintptr_t)(align - 1)) - base;
+		if (offset + size <= chunk.size) {
+			used = offset + size;
+			return chunk.data.get() + offset;
+		}
+
+		current++;
+		used = 0;
+	}
+}
+
+Arena::Marker Arena::Mark() const
+{
+	return { current, used };
+}
+
+void Arena::Rewind(Marker marker)
+{
+	current = marker.chunk;
+	used = marker.used;
+}
+
+void Arena::Reset()
+{
+	current = 0;
+	used = 0;
+}
+
+bool Arena::Owns(const void *p) const
+{
+	const std::byte *ptr = static_cast<const std::byte *>(p);
+	for (const Chunk &chunk : chunks) {
+		if (ptr >= chunk.data.get() && ptr < chunk.data.get() + chunk.size)
+			return true;
+	}
+
+	return false;
+}
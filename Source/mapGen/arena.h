@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Bump allocator for memory that only lives while a level is generated. Allocations
+ * are never freed one by one, Reset() releases everything at once and keeps the
+ * chunks around so the next level does not touch the system allocator.
+ */
+class Arena {
+public:
+	/** Position in the arena, everything allocated after it can be dropped with Rewind() */
+	struct Marker {
+		size_t chunk;
+		size_t used;
+	};
+
+	void *Allocate(size_t size, size_t align = alignof(std::max_align_t));
+	template <typename T, typename... Args>
+	T *New(Args &&...args);
+	Marker Mark() const;
+	void Rewind(Marker marker);
+	void Reset();
+	/**
+	 * @brief Check if the pointer was handed out by this arena
+	 */
+	bool Owns(const void *p) const;
+
+private:
+	struct Chunk {
+		std::unique_ptr<std::byte[]> data;
+		size_t size;
+	};
+
+	std::vector<Chunk> chunks;
+	size_t current = 0;
+	size_t used = 0;
+};
+
+template <typename T, typename... Args>
+T *Arena::New(Args &&...args)
+{
+	return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+}
@@ -0,0 +1,353 @@
+#include "attributes.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include "mappedFile.h"
+
+namespace {
+
+constexpr uint32_t BlockRows = 64 * 1024;
+
+struct AttributeName {
+	std::string_view name;
+	Attribute attribute;
+};
+
+constexpr AttributeName AttributeNames[] = {
+	{ "levelseed", Attribute::LevelSeed },
+	{ "ticks", Attribute::PathTicks },
+	{ "stairs", Attribute::StairsDistance },
+	{ "warp", Attribute::Warp },
+	{ "puzzlerx", Attribute::PuzzlerX },
+	{ "puzzlery", Attribute::PuzzlerY },
+};
+
+struct OpName {
+	std::string_view name;
+	AttributeFilter::Op op;
+};
+
+/** Two character operators first so "<=" is not read as "<" */
+constexpr OpName OpNames[] = {
+	{ "<=", AttributeFilter::LessEqual },
+	{ ">=", AttributeFilter::GreaterEqual },
+	{ "!=", AttributeFilter::NotEqual },
+	{ "<", AttributeFilter::Less },
+	{ ">", AttributeFilter::Greater },
+	{ "=", AttributeFilter::Equal },
+};
+
+struct AttributeBlock {
+	uint32_t rows;
+	const uint32_t *seeds;
+	const int32_t *values[AttributeCount];
+	const uint8_t *levels;
+	const uint8_t *present;
+};
+
+size_t ByteColumnsSize(uint32_t rows)
+{
+	return (2 * (size_t)rows + 3) & ~(size_t)3;
+}
+
+size_t BlockSize(uint32_t rows)
+{
+	return sizeof(AttributeBlockHeader) + (size_t)rows * sizeof(uint32_t) * (1 + AttributeCount) + ByteColumnsSize(rows);
+}
+
+bool ValidHeader(const MappedFile &file)
+{
+	if (file.Size() < sizeof(AttributeFileHeader))
+		return false;
+
+	AttributeFileHeader header;
+	memcpy(&header, file.Data(), sizeof(header));
+	return memcmp(header.magic, AttributeFileMagic, sizeof(AttributeFileMagic)) == 0
+	    && header.version == AttributeFileVersion
+	    && header.attributeCount == AttributeCount;
+}
+
+/**
+ * @brief Call fn for each block of a mapped attribute file
+ * @return False if the file is not a complete attribute file
+ */
+template <typename Fn>
+bool ForEachBlock(const MappedFile &file, Fn fn)
+{
+	if (!ValidHeader(file))
+		return false;
+
+	size_t offset = sizeof(AttributeFileHeader);
+	while (offset < file.Size()) {
+		if (file.Size() - offset < sizeof(AttributeBlockHeader))
+			return false;
+
+		AttributeBlockHeader header;
+		memcpy(&header, file.Data() + offset, sizeof(header));
+		if (file.Size() - offset < BlockSize(header.rows))
+			return false;
+
+		const char *columns = file.Data() + offset + sizeof(header);
+		AttributeBlock block;
+		block.rows = header.rows;
+		block.seeds = reinterpret_cast<const uint32_t *>(columns);
+		for (int i = 0; i < AttributeCount; i++)
+			block.values[i] = reinterpret_cast<const int32_t *>(columns + (size_t)(1 + i) * header.rows * sizeof(uint32_t));
+		block.levels = reinterpret_cast<const uint8_t *>(columns + (size_t)(1 + AttributeCount) * header.rows * sizeof(uint32_t));
+		block.present = block.levels + header.rows;
+		fn(block);
+
+		offset += BlockSize(header.rows);
+	}
+
+	return true;
+}
+
+template <AttributeFilter::Op Op>
+bool Compare(int32_t value, int32_t target)
+{
+	if constexpr (Op == AttributeFilter::Less)
+		return value < target;
+	else if constexpr (Op == AttributeFilter::LessEqual)
+		return value <= target;
+	else if constexpr (Op == AttributeFilter::Greater)
+		return value > target;
+	else if constexpr (Op == AttributeFilter::GreaterEqual)
+		return value >= target;
+	else if constexpr (Op == AttributeFilter::Equal)
+		return value == target;
+	else
+		return value != target;
+}
+
+/**
+ * @brief Set mask[i] for the rows that satisfy the filter
+ *
+ * The loop has no branches so the compiler turns it in to vector compares.
+ */
+template <AttributeFilter::Op Op>
+void ScanBlock(const AttributeBlock &block, const AttributeFilter &filter, uint8_t *mask)
+{
+	const int32_t *values = block.values[static_cast<int>(filter.attribute)];
+	const uint8_t bit = 1 << static_cast<int>(filter.attribute);
+	const bool anyLevel = !filter.level;
+	const uint8_t level = filter.level.value_or(0);
+
+	for (uint32_t i = 0; i < block.rows; i++)
+		mask[i] = (anyLevel | (block.levels[i] == level)) & ((block.present[i] & bit) != 0) & Compare<Op>(values[i], filter.value);
+}
+
+void ScanBlock(const AttributeBlock &block, const AttributeFilter &filter, uint8_t *mask)
+{
+	switch (filter.op) {
+	case AttributeFilter::Less:
+		return ScanBlock<AttributeFilter::Less>(block, filter, mask);
+	case AttributeFilter::LessEqual:
+		return ScanBlock<AttributeFilter::LessEqual>(block, filter, mask);
+	case AttributeFilter::Greater:
+		return ScanBlock<AttributeFilter::Greater>(block, filter, mask);
+	case AttributeFilter::GreaterEqual:
+		return ScanBlock<AttributeFilter::GreaterEqual>(block, filter, mask);
+	case AttributeFilter::Equal:
+		return ScanBlock<AttributeFilter::Equal>(block, filter, mask);
+	case AttributeFilter::NotEqual:
+		return ScanBlock<AttributeFilter::NotEqual>(block, filter, mask);
+	}
+}
+
+std::optional<AttributeFilter> ParseAttributeFilter(std::string_view text)
+{
+	AttributeFilter filter {};
+
+	size_t opPos = text.find_first_of("<>=!");
+	if (opPos == std::string_view::npos)
+		return std::nullopt;
+
+	std::string_view name = text.substr(0, opPos);
+	size_t at = name.find('@');
+	if (at != std::string_view::npos) {
+		std::string_view level = name.substr(at + 1);
+		int value;
+		auto [end, error] = std::from_chars(level.data(), level.data() + level.size(), value);
+		if (error != std::errc() || end != level.data() + level.size() || value < 0 || value > 255)
+			return std::nullopt;
+		filter.level = value;
+		name = name.substr(0, at);
+	}
+
+	auto attribute = std::find_if(std::begin(AttributeNames), std::end(AttributeNames), [name](const AttributeName &entry) { return entry.name == name; });
+	if (attribute == std::end(AttributeNames))
+		return std::nullopt;
+	filter.attribute = attribute->attribute;
+
+	std::string_view rest = text.substr(opPos);
+	auto op = std::find_if(std::begin(OpNames), std::end(OpNames), [rest](const OpName &entry) { return rest.substr(0, entry.name.size()) == entry.name; });
+	if (op == std::end(OpNames))
+		return std::nullopt;
+	filter.op = op->op;
+
+	// Level seeds are unsigned and stored by their bit pattern, so only equality is meaningful
+	if (filter.attribute == Attribute::LevelSeed && filter.op != AttributeFilter::Equal && filter.op != AttributeFilter::NotEqual)
+		return std::nullopt;
+
+	std::string_view number = rest.substr(op->name.size());
+	int64_t value;
+	auto [end, error] = std::from_chars(number.data(), number.data() + number.size(), value);
+	if (error != std::errc() || end != number.data() + number.size() || value < INT32_MIN || value > UINT32_MAX)
+		return std::nullopt;
+	filter.value = static_cast<int32_t>(static_cast<uint32_t>(value));
+
+	return filter;
+}
+
+}  // namespace
+
+AttributeWriter::~AttributeWriter()
+{
+	Close();
+}
+
+bool AttributeWriter::Open(const std::string &path)
+{
+	Close();
+
+	MappedFile existing;
+	bool hasHeader = false;
+	if (existing.Open(path) && existing.Size() != 0) {
+		// Refuse to append after a block that was cut short, it would hide everything after it
+		if (!ForEachBlock(existing, [](const AttributeBlock &) {}))
+			return false;
+		hasHeader = true;
+	}
+	existing.Close();
+
+	file = fopen(path.c_str(), "ab");
+	if (file == nullptr)
+		return false;
+
+	if (!hasHeader) {
+		AttributeFileHeader header {};
+		memcpy(header.magic, AttributeFileMagic, sizeof(AttributeFileMagic));
+		header.version = AttributeFileVersion;
+		header.attributeCount = AttributeCount;
+		fwrite(&header, 1, sizeof(header), file);
+	}
+
+	return true;
+}
+
+bool AttributeWriter::IsOpen() const
+{
+	return file != nullptr;
+}
+
+void AttributeWriter::Append(const AttributeRow &row)
+{
+	seeds.push_back(row.gameSeed);
+	for (int i = 0; i < AttributeCount; i++)
+		values[i].push_back(row.values[i]);
+	levels.push_back(row.level);
+	present.push_back(row.present);
+
+	if (seeds.size() == BlockRows)
+		WriteBlock();
+}
+
+void AttributeWriter::WriteBlock()
+{
+	AttributeBlockHeader header {};
+	header.rows = seeds.size();
+	if (header.rows == 0)
+		return;
+
+	fwrite(&header, 1, sizeof(header), file);
+	fwrite(seeds.data(), sizeof(uint32_t), seeds.size(), file);
+	for (std::vector<int32_t> &column : values)
+		fwrite(column.data(), sizeof(int32_t), column.size(), file);
+	fwrite(levels.data(), 1, levels.size(), file);
+	fwrite(present.data(), 1, present.size(), file);
+	const uint8_t padding[4] = {};
+	fwrite(padding, 1, ByteColumnsSize(header.rows) - 2 * header.rows, file);
+
+	seeds.clear();
+	for (std::vector<int32_t> &column : values)
+		column.clear();
+	levels.clear();
+	present.clear();
+}
+
+void AttributeWriter::Close()
+{
+	if (file == nullptr)
+		return;
+
+	WriteBlock();
+	fclose(file);
+	file = nullptr;
+}
+
+std::optional<std::vector<AttributeFilter>> ParseAttributeFilters(const std::string &text)
+{
+	std::vector<AttributeFilter> filters;
+
+	std::string_view rest = text;
+	while (!rest.empty()) {
+		size_t comma = rest.find(',');
+		std::optional<AttributeFilter> filter = ParseAttributeFilter(rest.substr(0, comma));
+		if (!filter)
+			return std::nullopt;
+		filters.push_back(*filter);
+		if (comma == std::string_view::npos)
+			break;
+		rest = rest.substr(comma + 1);
+	}
+
+	return filters;
+}
+
+std::optional<std::vector<uint32_t>> QueryAttributes(const std::string &path, const std::vector<AttributeFilter> &filters)
+{
+	MappedFile file;
+	if (!file.Open(path))
+		return std::nullopt;
+
+	// Each filter may be satisfied by a different row of the game seed, so collect the seeds per filter and intersect them
+	std::vector<std::vector<uint32_t>> matches(std::max<size_t>(filters.size(), 1));
+	std::vector<uint8_t> mask(BlockRows);
+	bool valid = ForEachBlock(file, [&](const AttributeBlock &block) {
+		if (mask.size() < block.rows)
+			mask.resize(block.rows);
+
+		if (filters.empty()) {
+			matches[0].insert(matches[0].end(), block.seeds, block.seeds + block.rows);
+			return;
+		}
+
+		for (size_t f = 0; f < filters.size(); f++) {
+			ScanBlock(block, filters[f], mask.data());
+			for (uint32_t i = 0; i < block.rows; i++) {
+				if (mask[i] != 0)
+					matches[f].push_back(block.seeds[i]);
+			}
+		}
+	});
+	if (!valid)
+		return std::nullopt;
+
+	for (std::vector<uint32_t> &seeds : matches) {
+		std::sort(seeds.begin(), seeds.end());
+		seeds.erase(std::unique(seeds.begin(), seeds.end()), seeds.end());
+	}
+
+	std::vector<uint32_t> result = std::move(matches[0]);
+	for (size_t f = 1; f < matches.size(); f++) {
+		std::vector<uint32_t> both;
+		std::set_intersection(result.begin(), result.end(), matches[f].begin(), matches[f].end(), std::back_inserter(both));
+		result = std::move(both);
+	}
+
+	return result;
+}
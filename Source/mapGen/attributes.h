@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Metrics the scanners record per game seed and level.
+ */
+enum class Attribute : uint8_t {
+	/** Level seed returned by the level generator */
+	LevelSeed,
+	/** Estimated ticks from the start of the game to the end of the level, path scanner */
+	PathTicks,
+	/** Steps from the spawn to the stairs down, stairs scanner */
+	StairsDistance,
+	/** 1 if the warp to Lazarus is on the level, 0 if not */
+	Warp,
+	/** Position of Naj's Puzzler, -1 if it is not on the level */
+	PuzzlerX,
+	PuzzlerY,
+};
+
+constexpr int AttributeCount = 6;
+
+struct AttributeRow {
+	uint32_t gameSeed;
+	uint8_t level;
+	/** Bit per attribute that was recorded */
+	uint8_t present;
+	/** Values by Attribute, level seeds are stored as their bit pattern */
+	int32_t values[AttributeCount];
+};
+
+/**
+ * Attribute files start with this header followed by blocks of rows. Each block is an
+ * AttributeBlockHeader, the game seed column (uint32), one int32 column per attribute, the
+ * level column (uint8) and the present column (uint8), padded to a multiple of 4 bytes.
+ */
+struct AttributeFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t attributeCount;
+	uint32_t reserved;
+};
+
+struct AttributeBlockHeader {
+	uint32_t rows;
+	uint32_t reserved;
+};
+
+constexpr char AttributeFileMagic[4] = { 'A', 'T', 'T', 'R' };
+constexpr uint32_t AttributeFileVersion = 1;
+
+/**
+ * Appends rows to an attribute file, rows are collected in a block that is written
+ * when it is full or the writer is closed.
+ */
+class AttributeWriter {
+public:
+	~AttributeWriter();
+
+	bool Open(const std::string &path);
+	bool IsOpen() const;
+	void Append(const AttributeRow &row);
+	void Close();
+
+private:
+	void WriteBlock();
+
+	FILE *file = nullptr;
+	std::vector<uint32_t> seeds;
+	std::vector<int32_t> values[AttributeCount];
+	std::vector<uint8_t> levels;
+	std::vector<uint8_t> present;
+};
+
+/**
+ * A condition on an attribute, all filters of a query must hold for a game seed
+ */
+struct AttributeFilter {
+	enum Op : uint8_t {
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		Equal,
+		NotEqual,
+	};
+
+	Attribute attribute;
+	/** Level the value must have been recorded on, or any level */
+	std::optional<uint8_t> level;
+	Op op;
+	int32_t value;
+};
+
+/**
+ * @brief Parse a comma separated list of filters like "ticks@16<=8400,warp=1"
+ */
+std::optional<std::vector<AttributeFilter>> ParseAttributeFilters(const std::string &text);
+/**
+ * @brief Find the game seeds that satisfy all filters
+ * @return Sorted game seeds, or nullopt if the file could not be read
+ */
+std::optional<std::vector<uint32_t>> QueryAttributes(const std::string &path, const std::vector<AttributeFilter> &filters);
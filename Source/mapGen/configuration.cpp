@@ -15,7 +15,9 @@ static void printHelp()
 {
 	std::cout << "--help         Print this message and exit" << std::endl;
 	std::cout << "--ascii        Print ASCII version of levels" << std::endl;
+	std::cout << "--ascii-plain  Print ASCII version of levels without colors" << std::endl;
 	std::cout << "--export       Export levels as .dun files" << std::endl;
+	std::cout << "--export-archive <#>  Export levels to a single archive file" << std::endl;
 	std::cout << "--scanner <#>  How to analyze levels [default: none]" << std::endl;
 	std::cout << "                   none: No analyzing" << std::endl;
 	std::cout << "                   puzzler: Search for Naj's Puzzler on level 9" << std::endl;
@@ -27,6 +29,12 @@ static void printHelp()
 	std::cout << "--start <#>    The seed to start from" << std::endl;
 	std::cout << "--count <#>    The number of seeds to process" << std::endl;
 	std::cout << "--seeds <#>    A file to read seeds from" << std::endl;
+	std::cout << "--seeds-out <#>  Also write found game seeds to a binary seed list" << std::endl;
+	std::cout << "--seeds-out-varint <#>  Same as --seeds-out, but delta and varint encoded" << std::endl;
+	std::cout << "--results <#>  Write found seeds to a binary results file instead of printing them" << std::endl;
+	std::cout << "--level-cache <#>  Reuse and extend a file of previously generated levels" << std::endl;
+	std::cout << "--attributes <#>  Record the metrics of scanned levels in an attribute file" << std::endl;
+	std::cout << "--query <#>    Print the game seeds in the attribute file that match the filters" << std::endl;
 	std::cout << "--target <#>   The target for the current filter [default: 420]" << std::endl;
 	std::cout << "--quiet        Do print status messages" << std::endl;
 	std::cout << "--verbose      Print out details about seeds" << std::endl;
@@ -50,8 +58,19 @@ Configuration Configuration::ParseArguments(int argc, char **argv)
 			config.quiet = true;
 		} else if (arg == "--ascii") {
 			config.asciiLevels = true;
+		} else if (arg == "--ascii-plain") {
+			config.asciiLevels = true;
+			config.plainAscii = true;
 		} else if (arg == "--export") {
 			config.exportLevels = true;
+		} else if (arg == "--export-archive") {
+			i++;
+			if (argc <= i) {
+				std::cerr << "Missing filename for --export-archive" << std::endl;
+				exit(255);
+			}
+			config.exportLevels = true;
+			config.exportArchive = argv[i];
 		} else if (arg == "--scanner") {
 			i++;
 			if (argc <= i) {
@@ -73,6 +92,42 @@ Configuration Configuration::ParseArguments(int argc, char **argv)
 			}
 			fromFile = true;
 			config.seedFile = argv[i];
+		} else if (arg == "--seeds-out" || arg == "--seeds-out-varint") {
+			i++;
+			if (argc <= i) {
+				std::cerr << "Missing filename for " << arg << std::endl;
+				exit(255);
+			}
+			config.seedsOut = argv[i];
+			config.seedsOutVarint = arg == "--seeds-out-varint";
+		} else if (arg == "--results") {
+			i++;
+			if (argc <= i) {
+				std::cerr << "Missing filename for --results" << std::endl;
+				exit(255);
+			}
+			config.resultsFile = argv[i];
+		} else if (arg == "--level-cache") {
+			i++;
+			if (argc <= i) {
+				std::cerr << "Missing filename for --level-cache" << std::endl;
+				exit(255);
+			}
+			config.levelCache = argv[i];
+		} else if (arg == "--attributes") {
+			i++;
+			if (argc <= i) {
+				std::cerr << "Missing filename for --attributes" << std::endl;
+				exit(255);
+			}
+			config.attributesFile = argv[i];
+		} else if (arg == "--query") {
+			i++;
+			if (argc <= i) {
+				std::cerr << "Missing filters for --query" << std::endl;
+				exit(255);
+			}
+			config.query = argv[i];
 		} else if (arg == "--start") {
 			i++;
 			if (argc <= i) {
@@ -103,6 +158,11 @@ Configuration Configuration::ParseArguments(int argc, char **argv)
 		}
 	}
 
+	if (!config.query.empty() && config.attributesFile.empty()) {
+		std::cerr << "--query requires --attributes" << std::endl;
+		exit(255);
+	}
+
 	if (fromFile && !hasCount) {
 		config.seedCount = std::numeric_limits<uint32_t>::max();
 	}
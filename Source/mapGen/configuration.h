@@ -12,10 +12,18 @@ struct Configuration {
 	uint32_t startSeed = 0;
 	uint32_t seedCount = 1;
 	std::string seedFile;
+	std::string seedsOut;
+	bool seedsOutVarint = false;
+	std::string resultsFile;
+	std::string levelCache;
+	std::string attributesFile;
+	std::string query;
 	Scanners scanner = Scanners::None;
 	bool quiet = false;
 	bool asciiLevels = false;
+	bool plainAscii = false;
 	bool exportLevels = false;
+	std::string exportArchive;
 	std::optional<uint32_t> target = std::nullopt;
 	bool verbose = false;
 };
\ No newline at end of file
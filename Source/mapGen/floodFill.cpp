@@ -0,0 +1,43 @@
+#include "floodFill.h"
+
+int FloodClear(uint8_t *cells, int size, int stride, int start)
+{
+	if (start < 0 || start >= size || cells[start] == 0)
+		return 0;
+
+	std::vector<int> seeds;
+	seeds.push_back(start);
+
+	int count = 0;
+	while (!seeds.empty()) {
+		int p = seeds.back();
+		seeds.pop_back();
+		if (cells[p] == 0)
+			continue;
+
+		int first = p;
+		while (first > 0 && cells[first - 1] != 0)
+			first--;
+		int last = p;
+		while (last + 1 < size && cells[last + 1] != 0)
+			last++;
+
+		for (int q = first; q <= last; q++)
+			cells[q] = 0;
+		count += last - first + 1;
+
+		// One seed per run in the neighbouring lines
+		for (int offset : { -stride, stride }) {
+			for (int q = first; q <= last; q++) {
+				int n = q + offset;
+				if (n < 0 || n >= size || cells[n] == 0)
+					continue;
+				if (q != first && n > 0 && cells[n - 1] != 0)
+					continue;
+				seeds.push_back(n);
+			}
+		}
+	}
+
+	return count;
+}
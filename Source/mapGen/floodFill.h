@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Flood fills for the level generators, without recursion so they neither depend on
+ * the size of the thread stack nor pay for a call per cell.
+ */
+
+/**
+ * @brief Clear the cells connected to start and count them
+ *
+ * cells is a flat grid where cell p neighbours p - 1, p + 1, p - stride and p + stride,
+ * the same as indexing a [width][stride] array past the ends of its rows. Runs of
+ * neighbouring cells along p are cleared at once before moving on to the runs next to
+ * them.
+ * @return Number of cleared cells
+ */
+int FloodClear(uint8_t *cells, int size, int stride, int start);
+
+enum class FloodStep : uint8_t {
+	/** Do not visit the children of the node */
+	Skip,
+	/** Visit the children of the node */
+	Expand,
+	/** End the fill */
+	Stop,
+};
+
+/**
+ * @brief Depth first fill that visits the nodes in the same order as a recursive fill
+ *
+ * enter(node) is called when a node is reached, it may update the node and decides
+ * if it is expanded, the expanded nodes are kept on an explicit stack. next(node, child)
+ * produces the next child of an expanded node, which keeps its own position among its
+ * children, and returns false once there are no more.
+ * @return False if enter stopped the fill
+ */
+template <typename Node, typename Enter, typename Next>
+bool OrderedFlood(Node root, Enter enter, Next next)
+{
+	std::vector<Node> stack;
+
+	FloodStep step = enter(root);
+	if (step == FloodStep::Stop)
+		return false;
+	if (step == FloodStep::Expand)
+		stack.push_back(root);
+
+	while (!stack.empty()) {
+		Node child;
+		if (!next(stack.back(), child)) {
+			stack.pop_back();
+			continue;
+		}
+
+		step = enter(child);
+		if (step == FloodStep::Stop)
+			return false;
+		if (step == FloodStep::Expand)
+			stack.push_back(child);
+	}
+
+	return true;
+}
@@ -0,0 +1,127 @@
+#include "freeCells.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+struct AreaBounds {
+	int x1;
+	int y1;
+	int x2;
+	int y2;
+};
+
+constexpr AreaBounds Bounds[FreeCells::AreaCount] = {
+	{ 0, 0, 0, 0 },
+	{ -1, -1, 1, 1 },
+	{ -1, -2, 1, 1 },
+	{ -2, -2, 2, 2 },
+};
+
+/** Largest distance from the probed position to the edge of an area */
+constexpr int MaxReach = 2;
+
+/**
+ * @brief Shift a row so bit y of the result is bit y + offset of the input
+ */
+template <size_t Words>
+void ShiftRow(const uint64_t (&in)[Words], int offset, uint64_t (&out)[Words])
+{
+	int shift = offset < 0 ? -offset : offset;
+	int wordShift = shift / 64;
+	int bitShift = shift % 64;
+
+	for (int i = 0; i < (int)Words; i++) {
+		int from = offset < 0 ? i - wordShift : i + wordShift;
+		int carry = offset < 0 ? from - 1 : from + 1;
+		uint64_t word = 0;
+		if (from >= 0 && from < (int)Words)
+			word = offset < 0 ? in[from] << bitShift : in[from] >> bitShift;
+		if (bitShift != 0 && carry >= 0 && carry < (int)Words)
+			word |= offset < 0 ? in[carry] >> (64 - bitShift) : in[carry] << (64 - bitShift);
+		out[i] = word;
+	}
+}
+
+}  // namespace
+
+void FreeCells::Invalidate()
+{
+	valid = false;
+}
+
+bool FreeCells::IsValid() const
+{
+	return valid;
+}
+
+bool FreeCells::IsFree(Area area, int x, int y) const
+{
+	if (x < 0 || x >= MAXDUNX || y < 0 || y >= MAXDUNY)
+		return false;
+
+	return (areas[area][x].words[y / 64] >> (y % 64)) & 1;
+}
+
+int FreeCells::Count(int x1, int y1, int x2, int y2) const
+{
+	x1 = std::max(x1, 0);
+	y1 = std::max(y1, 0);
+	x2 = std::min(x2, MAXDUNX - 1);
+	y2 = std::min(y2, MAXDUNY - 1);
+
+	int count = 0;
+	for (int x = x1; x <= x2; x++) {
+		for (int y = y1; y <= y2;) {
+			int bit = y % 64;
+			int bits = std::min(64 - bit, y2 - y + 1);
+			uint64_t mask = bits == 64 ? ~0ULL : ((1ULL << bits) - 1) << bit;
+			count += std::popcount(areas[AreaTile][x].words[y / 64] & mask);
+			y += bits;
+		}
+	}
+
+	return count;
+}
+
+void FreeCells::SetTile(int x, int y, bool free)
+{
+	uint64_t bit = 1ULL << (y % 64);
+	if (free)
+		areas[AreaTile][x].words[y / 64] |= bit;
+	else
+		areas[AreaTile][x].words[y / 64] &= ~bit;
+}
+
+/**
+ * @brief Recompute the area bitmaps that depend on the tiles of columns x1 to x2
+ */
+void FreeCells::UpdateAreas(int x1, int x2)
+{
+	x1 = std::max(x1 - MaxReach, 0);
+	x2 = std::min(x2 + MaxReach, MAXDUNX - 1);
+
+	for (int area = AreaTile + 1; area < AreaCount; area++) {
+		const AreaBounds &bounds = Bounds[area];
+		for (int x = x1; x <= x2; x++) {
+			Row &row = areas[area][x];
+			for (uint64_t &word : row.words)
+				word = ~0ULL;
+
+			for (int dx = bounds.x1; dx <= bounds.x2; dx++) {
+				if (x + dx < 0 || x + dx >= MAXDUNX) {
+					row = {};
+					break;
+				}
+
+				for (int dy = bounds.y1; dy <= bounds.y2; dy++) {
+					Row shifted;
+					ShiftRow(areas[AreaTile][x + dx].words, dy, shifted.words);
+					for (int i = 0; i < RowWords; i++)
+						row.words[i] &= shifted.words[i];
+				}
+			}
+		}
+	}
+}
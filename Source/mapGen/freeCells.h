@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../../types.h"
+
+/**
+ * One bit per dungeon tile telling if something can be placed there, plus for each
+ * area shape used by the placement code a bitmap of the positions where the whole
+ * area is free, so testing a candidate location is a single bit probe.
+ *
+ * The map is only valid between Build() and Invalidate(), the code writing to the
+ * dungeon grids in between reports the tiles it changed with Update().
+ */
+class FreeCells {
+public:
+	/** Areas relative to the probed position */
+	enum Area : uint8_t {
+		/** The tile itself */
+		AreaTile,
+		/** x - 1 to x + 1, y - 1 to y + 1 */
+		Area3x3,
+		/** x - 1 to x + 1, y - 2 to y + 1 */
+		Area3x4,
+		/** x - 2 to x + 2, y - 2 to y + 2 */
+		Area5x5,
+		AreaCount,
+	};
+
+	template <typename Predicate>
+	void Build(Predicate isFree);
+	template <typename Predicate>
+	void Update(int x1, int y1, int x2, int y2, Predicate isFree);
+	void Invalidate();
+	bool IsValid() const;
+	bool IsFree(Area area, int x, int y) const;
+	/**
+	 * @brief Count the free tiles from (x1, y1) to (x2, y2) inclusive
+	 */
+	int Count(int x1, int y1, int x2, int y2) const;
+
+private:
+	static constexpr int RowWords = (MAXDUNY + 63) / 64;
+
+	/** The tiles of a column, bit y of the row is tile (x, y) */
+	struct Row {
+		uint64_t words[RowWords];
+	};
+
+	void SetTile(int x, int y, bool free);
+	void UpdateAreas(int x1, int x2);
+
+	Row areas[AreaCount][MAXDUNX];
+	bool valid = false;
+};
+
+template <typename Predicate>
+void FreeCells::Build(Predicate isFree)
+{
+	for (int x = 0; x < MAXDUNX; x++) {
+		for (int y = 0; y < MAXDUNY; y++)
+			SetTile(x, y, isFree(x, y));
+	}
+
+	valid = true;
+	UpdateAreas(0, MAXDUNX - 1);
+}
+
+template <typename Predicate>
+void FreeCells::Update(int x1, int y1, int x2, int y2, Predicate isFree)
+{
+	if (!valid)
+		return;
+
+	x1 = x1 < 0 ? 0 : x1;
+	y1 = y1 < 0 ? 0 : y1;
+	x2 = x2 >= MAXDUNX ? MAXDUNX - 1 : x2;
+	y2 = y2 >= MAXDUNY ? MAXDUNY - 1 : y2;
+	if (x1 > x2 || y1 > y2)
+		return;
+
+	for (int x = x1; x <= x2; x++) {
+		for (int y = y1; y <= y2; y++)
+			SetTile(x, y, isFree(x, y));
+	}
+
+	UpdateAreas(x1, x2);
+}
@@ -0,0 +1,111 @@
+#include "levelCache.h"
+
+#include <cstring>
+
+bool LevelKey::operator==(const LevelKey &other) const
+{
+	return memcmp(this, &other, sizeof(LevelKey)) == 0;
+}
+
+/**
+ * @brief FNV-1a over the key
+ */
+size_t LevelCache::KeyHash::operator()(const LevelKey &key) const
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&key);
+	uint64_t hash = 14695981039346656037ULL;
+	for (size_t i = 0; i < sizeof(LevelKey); i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+LevelCache::~LevelCache()
+{
+	Close();
+}
+
+bool LevelCache::Open(const std::string &path)
+{
+	Close();
+
+	file = fopen(path.c_str(), "ab");
+	if (file == nullptr)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long fileSize = ftell(file);
+	if (fileSize == 0) {
+		LevelCacheHeader header {};
+		memcpy(header.magic, LevelCacheMagic, sizeof(LevelCacheMagic));
+		header.version = LevelCacheVersion;
+		header.recordSize = sizeof(LevelFeatures);
+		fwrite(&header, 1, sizeof(header), file);
+		return true;
+	}
+
+	// Records must only be appended after a header that has been checked
+	if (fileSize < 0 || !ReadRecords(path, fileSize)) {
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Map the records of an existing cache file and index them
+ */
+bool LevelCache::ReadRecords(const std::string &path, size_t fileSize)
+{
+	if (!mapped.Open(path) || mapped.Size() != fileSize)
+		return false;
+
+	LevelCacheHeader header;
+	if (mapped.Size() < sizeof(header))
+		return false;
+	memcpy(&header, mapped.Data(), sizeof(header));
+	if (memcmp(header.magic, LevelCacheMagic, sizeof(LevelCacheMagic)) != 0
+	    || header.version != LevelCacheVersion
+	    || header.recordSize != sizeof(LevelFeatures))
+		return false;
+	// A partly written record from an interrupted run would misalign everything appended after it
+	if ((mapped.Size() - sizeof(header)) % sizeof(LevelFeatures) != 0)
+		return false;
+
+	size_t records = (mapped.Size() - sizeof(header)) / sizeof(LevelFeatures);
+	const LevelFeatures *features = reinterpret_cast<const LevelFeatures *>(mapped.Data() + sizeof(header));
+	for (size_t i = 0; i < records; i++)
+		index[features[i].key] = &features[i];
+
+	return true;
+}
+
+bool LevelCache::IsOpen() const
+{
+	return file != nullptr;
+}
+
+const LevelFeatures *LevelCache::Find(const LevelKey &key) const
+{
+	auto it = index.find(key);
+	if (it == index.end())
+		return nullptr;
+	return it->second;
+}
+
+void LevelCache::Add(const LevelFeatures &features)
+{
+	fwrite(&features, sizeof(features), 1, file);
+}
+
+void LevelCache::Close()
+{
+	if (file != nullptr)
+		fclose(file);
+	file = nullptr;
+	index.clear();
+	mapped.Close();
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+#include "mappedFile.h"
+
+/**
+ * Everything a generated level depends on, besides the fixed game data.
+ */
+struct LevelKey {
+	/** glSeedTbl entry of the level */
+	uint32_t dungeonSeed;
+	/** Bit per quest that is available in the game */
+	uint32_t questMask;
+	/** Bit per unique item that had already dropped before the level was generated */
+	uint32_t uniqueItems[4];
+	uint8_t level;
+	/** DungeonMode the level was generated with */
+	uint8_t mode;
+	uint16_t reserved;
+
+	bool operator==(const LevelKey &other) const;
+};
+
+/**
+ * Compact summary of a generated level. Positions are -1 when not found, the content
+ * fields are only filled in for levels generated with DungeonMode::Full.
+ */
+struct LevelFeatures {
+	LevelKey key;
+	uint32_t levelSeed;
+	uint8_t flags;
+	uint8_t monsterTypeCount;
+	int8_t spawnX;
+	int8_t spawnY;
+	int8_t stairsDownX;
+	int8_t stairsDownY;
+	int8_t poiX;
+	int8_t poiY;
+	uint8_t monsterTypes[24];
+	uint16_t monsterCount;
+	uint16_t objectCount;
+	uint16_t itemCount;
+	uint16_t reserved;
+	/** Unique items that had dropped once the level was generated */
+	uint32_t uniqueItemsAfter[4];
+};
+
+constexpr uint8_t LevelHasLevelSeed = 1 << 0;
+
+/**
+ * Level cache files start with this header followed by LevelFeatures records.
+ */
+struct LevelCacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t recordSize;
+	uint32_t reserved;
+};
+
+constexpr char LevelCacheMagic[4] = { 'L', 'V', 'L', 'C' };
+constexpr uint32_t LevelCacheVersion = 1;
+
+/**
+ * Append-only file of generated levels. The records already in the file are memory
+ * mapped when it is opened, new records are only written to the file, so they can be
+ * found once it is opened again.
+ */
+class LevelCache {
+public:
+	~LevelCache();
+
+	bool Open(const std::string &path);
+	bool IsOpen() const;
+	const LevelFeatures *Find(const LevelKey &key) const;
+	void Add(const LevelFeatures &features);
+	void Close();
+
+private:
+	struct KeyHash {
+		size_t operator()(const LevelKey &key) const;
+	};
+
+	bool ReadRecords(const std::string &path, size_t fileSize);
+
+	MappedFile mapped;
+	FILE *file = nullptr;
+	std::unordered_map<LevelKey, const LevelFeatures *, KeyHash> index;
+};
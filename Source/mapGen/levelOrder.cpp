@@ -0,0 +1,73 @@
+#include "levelOrder.h"
+
+#include <algorithm>
+
+namespace {
+
+/** Number of recorded levels between each re-evaluation of the order */
+constexpr uint32_t SortInterval = 1024;
+
+}  // namespace
+
+void LevelOrder::setLevels(uint32_t levelMask)
+{
+	this->levelMask = levelMask;
+	order.clear();
+	for (int level = 1; level < NUMLEVELS; level++) {
+		if (contains(level))
+			order.push_back(level);
+	}
+}
+
+bool LevelOrder::empty() const
+{
+	return order.empty();
+}
+
+bool LevelOrder::contains(int level) const
+{
+	return (levelMask & (1U << level)) != 0;
+}
+
+const std::vector<int> &LevelOrder::levels() const
+{
+	return order;
+}
+
+void LevelOrder::record(int level, bool matched, uint64_t elapsed)
+{
+	LevelStats &levelStats = stats[level];
+	levelStats.evaluations++;
+	levelStats.elapsed += elapsed;
+	if (!matched)
+		levelStats.rejections++;
+
+	if (++samplesSinceSort < SortInterval)
+		return;
+	samplesSinceSort = 0;
+	sort();
+}
+
+/**
+ * @brief Average time spent per seed rejected by the level
+ *
+ * Levels that have not been sampled yet report no cost so they get tried early.
+ */
+double LevelOrder::expectedCost(int level) const
+{
+	const LevelStats &levelStats = stats[level];
+	if (levelStats.evaluations == 0)
+		return 0;
+
+	double averageCost = (double)levelStats.elapsed / levelStats.evaluations;
+	double rejectionRate = (double)(levelStats.rejections + 1) / (levelStats.evaluations + 2);
+
+	return averageCost / rejectionRate;
+}
+
+void LevelOrder::sort()
+{
+	std::stable_sort(order.begin(), order.end(), [this](int lhs, int rhs) {
+		return expectedCost(lhs) < expectedCost(rhs);
+	});
+}
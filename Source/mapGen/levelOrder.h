@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "../../types.h"
+
+/**
+ * Picks the order in which a scanner's independent levels are generated.
+ *
+ * Tracks how often each level rejects a seed and how long it takes to do so,
+ * and keeps the levels sorted so the cheapest way to reject a seed is tried first.
+ */
+class LevelOrder {
+public:
+	void setLevels(uint32_t levelMask);
+	bool empty() const;
+	bool contains(int level) const;
+	const std::vector<int> &levels() const;
+	void record(int level, bool matched, uint64_t elapsed);
+
+private:
+	struct LevelStats {
+		uint64_t evaluations = 0;
+		uint64_t rejections = 0;
+		uint64_t elapsed = 0;
+	};
+
+	double expectedCost(int level) const;
+	void sort();
+
+	uint32_t levelMask = 0;
+	std::vector<int> order;
+	LevelStats stats[NUMLEVELS];
+	uint32_t samplesSinceSort = 0;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <type_traits>
+
+#include "../engine.h"
+
+/** A level type as a compile time constant, see DispatchLevelType() */
+template <int LevelType>
+using LevelTypeConstant = std::integral_constant<int, LevelType>;
+
+/**
+ * @brief Call fn with the current leveltype as a LevelTypeConstant, so code taking the
+ * level type as a template parameter has its level type checks resolved at compile time
+ */
+template <typename Fn>
+decltype(auto) DispatchLevelType(Fn &&fn)
+{
+	switch (leveltype) {
+	case DTYPE_CATHEDRAL:
+		return fn(LevelTypeConstant<DTYPE_CATHEDRAL>());
+	case DTYPE_CATACOMBS:
+		return fn(LevelTypeConstant<DTYPE_CATACOMBS>());
+	case DTYPE_CAVES:
+		return fn(LevelTypeConstant<DTYPE_CAVES>());
+	case DTYPE_HELL:
+		return fn(LevelTypeConstant<DTYPE_HELL>());
+	default:
+		app_fatal("DispatchLevelType");
+	}
+}
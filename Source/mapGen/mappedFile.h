@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A read-only memory mapping of a whole file.
+ */
+class MappedFile {
+public:
+	~MappedFile();
+
+	/**
+	 * @brief Map the file, an empty file is mapped as no data
+	 * @param sequential Hint that the file is read once from start to end
+	 * @return False if the file could not be opened or mapped
+	 */
+	bool Open(const std::string &path, bool sequential = false);
+	const char *Data() const;
+	size_t Size() const;
+	void Close();
+
+private:
+	const char *data = nullptr;
+	size_t size = 0;
+#ifdef _WIN32
+	void *fileHandle = nullptr;
+	void *mappingHandle = nullptr;
+#endif
+};
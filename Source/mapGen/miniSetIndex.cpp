@@ -0,0 +1,186 @@
+#include "miniSetIndex.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+void MiniSetIndex::Build(const BYTE *miniset, const BYTE (*dungeon)[DMAXY], const BYTE (*flags)[DMAXY])
+{
+	this->miniset = miniset;
+	this->dungeon = dungeon;
+	this->flags = flags;
+	sw = miniset[0];
+	sh = miniset[1];
+	width = DMAXX - sw;
+	height = DMAXY - sh;
+
+	memset(slots, MaxTiles, sizeof(slots));
+	tileCount = 0;
+	for (int i = 2; i < sw * sh + 2; i++) {
+		if (miniset[i] != 0 && slots[miniset[i]] == MaxTiles) {
+			assert(tileCount < MaxTiles);
+			slots[miniset[i]] = tileCount++;
+		}
+	}
+
+	tilesRead = 0;
+	rowsComputed = 0;
+	memset(excluded, 0, sizeof(excluded));
+	memset(stops, 0, sizeof(stops));
+}
+
+/**
+ * @brief Load dungeon row y in to tileRows and flagRows
+ */
+void MiniSetIndex::ReadTiles(int y)
+{
+	for (int slot = 0; slot < tileCount; slot++)
+		tileRows[slot][y] = 0;
+	tileRows[MaxTiles][y] = 0;
+	flagRows[y] = 0;
+
+	// No branches, the tiles of a generated level are too random to predict
+	for (int x = 0; x < DMAXX; x++) {
+		tileRows[slots[dungeon[x][y]]][y] |= 1ULL << x;
+		flagRows[y] |= (uint64_t)(flags[x][y] != 0) << x;
+	}
+
+	tilesRead |= 1ULL << y;
+}
+
+/**
+ * @brief Refresh the tile and flag bits of (x, y)
+ */
+void MiniSetIndex::SetTile(int x, int y)
+{
+	uint64_t bit = 1ULL << x;
+	for (int slot = 0; slot < tileCount; slot++)
+		tileRows[slot][y] &= ~bit;
+	tileRows[slots[dungeon[x][y]]][y] |= bit;
+
+	if (flags[x][y] != 0)
+		flagRows[y] |= bit;
+	else
+		flagRows[y] &= ~bit;
+}
+
+void MiniSetIndex::Update(int sx, int sy)
+{
+	for (int y = sy; y < sy + sh; y++) {
+		if ((tilesRead & (1ULL << y)) == 0)
+			continue;
+		for (int x = sx; x < sx + sw; x++)
+			SetTile(x, y);
+	}
+
+	for (int y = std::max(sy - sh + 1, 0); y < std::min(sy + sh, height); y++)
+		rowsComputed &= ~(1ULL << y);
+}
+
+/**
+ * @brief Compare the miniset at all positions of row sy
+ *
+ * The whole row is compared at once by shifting the tile bits of each miniset tile
+ * in to place.
+ */
+void MiniSetIndex::ComputeRow(int sy)
+{
+	for (int y = sy; y < sy + sh; y++) {
+		if ((tilesRead & (1ULL << y)) == 0)
+			ReadTiles(y);
+	}
+
+	uint64_t row = (1ULL << width) - 1;
+	int ii = 2;
+	for (int yy = 0; yy < sh; yy++) {
+		for (int xx = 0; xx < sw; xx++, ii++) {
+			if (miniset[ii] != 0)
+				row &= tileRows[slots[miniset[ii]]][sy + yy] >> xx;
+			row &= ~flagRows[sy + yy] >> xx;
+		}
+	}
+
+	matches[sy] = row;
+	rowsComputed |= 1ULL << sy;
+}
+
+void MiniSetIndex::SetRect(uint64_t (&rows)[DMAXY], int x1, int y1, int x2, int y2)
+{
+	x1 = std::max(x1, 0);
+	y1 = std::max(y1, 0);
+	x2 = std::min(x2, width - 1);
+	y2 = std::min(y2, height - 1);
+	if (x1 > x2)
+		return;
+
+	uint64_t bits = ((2ULL << (x2 - x1)) - 1) << x1;
+	for (int sy = y1; sy <= y2; sy++)
+		rows[sy] |= bits;
+}
+
+void MiniSetIndex::Exclude(int x1, int y1, int x2, int y2)
+{
+	SetRect(excluded, x1, y1, x2, y2);
+}
+
+void MiniSetIndex::Stop(int x1, int y1, int x2, int y2)
+{
+	SetRect(stops, x1, y1, x2, y2);
+}
+
+bool MiniSetIndex::Contains(int sx, int sy) const
+{
+	return sx >= 0 && sx < width && sy >= 0 && sy < height;
+}
+
+bool MiniSetIndex::Matches(int sx, int sy)
+{
+	if ((rowsComputed & (1ULL << sy)) == 0)
+		ComputeRow(sy);
+
+	return (matches[sy] >> sx) & 1;
+}
+
+uint64_t MiniSetIndex::StopRow(int sy)
+{
+	if ((rowsComputed & (1ULL << sy)) == 0)
+		ComputeRow(sy);
+
+	return (matches[sy] & ~excluded[sy]) | stops[sy];
+}
+
+int MiniSetIndex::Distance(int sx, int sy, int limit)
+{
+	if (!Contains(sx, sy))
+		return 0;
+
+	// Positions the walk has its own logic for are checked first, as the row may not be needed at all
+	if ((stops[sy] >> sx) & 1)
+		return 0;
+
+	uint64_t row = StopRow(sy) >> sx;
+	if (row != 0)
+		return std::min(std::countr_zero(row), limit);
+
+	int steps = width - sx;
+	for (int i = 1; i <= height && steps < limit; i++) {
+		int y = (sy + i) % height;
+		row = StopRow(y);
+		if (row != 0)
+			return std::min(steps + std::countr_zero(row), limit);
+		steps += width;
+	}
+
+	return limit;
+}
+
+void MiniSetIndex::Advance(int &sx, int &sy, int steps) const
+{
+	if (steps == 0)
+		return;
+
+	int i = (sy * width + sx + steps) % (width * height);
+	sx = i % width;
+	sy = i / width;
+}
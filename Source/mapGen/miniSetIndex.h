@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../../types.h"
+
+/**
+ * The positions where a miniset can be placed, for the placement walks of the level
+ * generators.
+ *
+ * The walks start at a random position and step through the positions in rows until
+ * the miniset matches the dungeon, giving up after a number of steps. The index lets a
+ * walk jump straight to the next position where something can happen instead of
+ * comparing the miniset at every step, so the chosen position and the RNG calls stay
+ * the same.
+ *
+ * Rows of positions are only compared once a walk reaches them, most walks end
+ * within a few rows of where they started.
+ *
+ * Positions are (sx, sy) with sx < DMAXX - width and sy < DMAXY - height.
+ */
+class MiniSetIndex {
+public:
+	/**
+	 * @brief Index the positions where the non zero tiles of miniset match dungeon and all flags are clear
+	 */
+	void Build(const BYTE *miniset, const BYTE (*dungeon)[DMAXY], const BYTE (*flags)[DMAXY]);
+	/**
+	 * @brief Forget the positions that overlap a miniset placed at (sx, sy)
+	 */
+	void Update(int sx, int sy);
+	/**
+	 * @brief Positions from (x1, y1) to (x2, y2) the walk always steps over
+	 */
+	void Exclude(int x1, int y1, int x2, int y2);
+	/**
+	 * @brief Positions from (x1, y1) to (x2, y2) where the walk has its own logic and must not be jumped over
+	 */
+	void Stop(int x1, int y1, int x2, int y2);
+	bool Contains(int sx, int sy) const;
+	bool Matches(int sx, int sy);
+	/**
+	 * @brief Number of steps from (sx, sy) to the next matching or stop position
+	 * @return At most limit, 0 if (sx, sy) is outside the index
+	 */
+	int Distance(int sx, int sy, int limit);
+	/**
+	 * @brief Take steps the same way the walks do, wrapping to the next row and back to the top
+	 */
+	void Advance(int &sx, int &sy, int steps) const;
+
+private:
+	/** Largest number of different tiles in a miniset, the biggest ones are 11x11 */
+	static constexpr int MaxTiles = 11 * 11;
+
+	void ReadTiles(int y);
+	void SetTile(int x, int y);
+	void ComputeRow(int sy);
+	void SetRect(uint64_t (&rows)[DMAXY], int x1, int y1, int x2, int y2);
+	uint64_t StopRow(int sy);
+
+	const BYTE *miniset;
+	const BYTE (*dungeon)[DMAXY];
+	const BYTE (*flags)[DMAXY];
+	int sw;
+	int sh;
+	/** Number of positions per row */
+	int width;
+	/** Number of rows */
+	int height;
+	int tileCount;
+	/** Index in to tileRows of each tile value, tiles the miniset does not use share the last entry */
+	uint8_t slots[256];
+	/** Bit y is set once tileRows and flagRows hold dungeon row y */
+	uint64_t tilesRead;
+	/** Bit sy is set once matches holds position row sy */
+	uint64_t rowsComputed;
+	/** For each miniset tile and dungeon row, bit x is set if dungeon[x][y] is that tile */
+	uint64_t tileRows[MaxTiles + 1][DMAXY];
+	/** Bit x is set if flags[x][y] is not 0 */
+	uint64_t flagRows[DMAXY];
+	/** Bit sx of row sy is set if the miniset can be placed at (sx, sy) */
+	uint64_t matches[DMAXY];
+	uint64_t excluded[DMAXY];
+	uint64_t stops[DMAXY];
+};
@@ -0,0 +1,244 @@
+#include "pathQuery.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+/** The 8 step directions, in the order FindPath tries them */
+constexpr int8_t StepX[8] = { -1, -1, 1, 1, -1, 0, 1, 0 };
+constexpr int8_t StepY[8] = { -1, 1, -1, 1, 0, -1, 0, 1 };
+/** Step directions by 3 * (dy + 1) + dx + 1, like path_directions */
+constexpr char StepDirections[9] = { 5, 1, 6, 2, 0, 3, 8, 4, 7 };
+
+char StepDirection(int dx, int dy)
+{
+	return StepDirections[3 * (dy + 1) + dx + 1];
+}
+
+/**
+ * @brief End the steps of a path of the given length
+ * @return length
+ */
+int Terminate(std::span<char> steps, int length)
+{
+	if (length < (int)steps.size())
+		steps[length] = 0;
+
+	return length;
+}
+
+int HeuristicCost(int sx, int sy, int dx, int dy)
+{
+	int deltaX = std::abs(sx - dx);
+	int deltaY = std::abs(sy - dy);
+
+	return 2 * (std::min(deltaX, deltaY) + std::max(deltaX, deltaY));
+}
+
+int StepCost(int sx, int sy, int dx, int dy)
+{
+	if (sx == dx || sy == dy)
+		return 2;
+
+	return 3;
+}
+
+}  // namespace
+
+PathQuery::PathQuery(const Walkability &walkability)
+    : walkability(&walkability)
+{
+}
+
+int PathQuery::CellIndex(int x, int y)
+{
+	return (x + 1) * GridHeight + y + 1;
+}
+
+int PathQuery::NodeAt(int x, int y) const
+{
+	int cell = CellIndex(x, y);
+	if (cellEpoch[cell] != epoch)
+		return -1;
+
+	return cellNode[cell];
+}
+
+int PathQuery::NewNode(int x, int y, Point goal)
+{
+	int index = nodeCount++;
+	Node &node = nodes[index];
+	node.g = 0;
+	node.h = HeuristicCost(x, y, goal.x, goal.y);
+	node.f = node.h;
+	node.x = x;
+	node.y = y;
+	node.parent = -1;
+	node.next = -1;
+	node.childCount = 0;
+	node.visited = false;
+
+	int cell = CellIndex(x, y);
+	cellEpoch[cell] = epoch;
+	cellNode[cell] = index;
+
+	return index;
+}
+
+/**
+ * @brief Check that a step does not cut a corner, see path_solid_pieces
+ */
+bool PathQuery::CanStep(const Node &from, int dx, int dy) const
+{
+	switch (StepDirection(dx - from.x, dy - from.y)) {
+	case 5:
+		return !walkability->IsSolid(dx, dy + 1) && !walkability->IsSolid(dx + 1, dy);
+	case 6:
+		return !walkability->IsSolid(dx, dy + 1) && !walkability->IsSolid(dx - 1, dy);
+	case 7:
+		return !walkability->IsSolid(dx, dy - 1) && !walkability->IsSolid(dx - 1, dy);
+	case 8:
+		return !walkability->IsSolid(dx + 1, dy) && !walkability->IsSolid(dx, dy - 1);
+	}
+
+	return true;
+}
+
+/**
+ * @brief Try the steps in every direction from a node, see path_get_path
+ * @return False if the nodes ran out
+ */
+bool PathQuery::Expand(int current, Point goal)
+{
+	for (int i = 0; i < 8; i++) {
+		int dx = nodes[current].x + StepX[i];
+		int dy = nodes[current].y + StepY[i];
+		bool ok = walkability->IsWalkable(dx, dy);
+		if ((ok && CanStep(nodes[current], dx, dy)) || (!ok && dx == goal.x && dy == goal.y)) {
+			if (!AddStep(current, dx, dy, goal))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * @brief Add the step from a node to (dx, dy), see path_parent_path
+ * @return False if the nodes ran out
+ */
+bool PathQuery::AddStep(int current, int dx, int dy, Point goal)
+{
+	Node &parent = nodes[current];
+	int nextG = parent.g + StepCost(parent.x, parent.y, dx, dy);
+
+	int index = NodeAt(dx, dy);
+	if (index != -1) {
+		Node &node = nodes[index];
+		parent.children[parent.childCount++] = index;
+		if (nextG < node.g && CanStep(parent, dx, dy)) {
+			node.parent = current;
+			node.g = nextG;
+			node.f = nextG + node.h;
+			// Already explored, so update the nodes reached through it
+			if (node.visited)
+				UpdateChildren(index);
+		}
+		return true;
+	}
+
+	if (nodeCount == MaxNodes)
+		return false;
+
+	index = NewNode(dx, dy, goal);
+	Node &node = nodes[index];
+	node.parent = current;
+	node.g = nextG;
+	node.f = nextG + node.h;
+	InsertFrontier(index);
+	parent.children[parent.childCount++] = index;
+
+	return true;
+}
+
+/**
+ * @brief Insert a node before the first one on the frontier whose cost is not lower
+ */
+void PathQuery::InsertFrontier(int current)
+{
+	int f = nodes[current].f;
+	int16_t *link = &frontier;
+	while (*link != -1 && nodes[*link].f < f)
+		link = &nodes[*link].next;
+
+	nodes[current].next = *link;
+	*link = current;
+}
+
+/**
+ * @brief Carry a lower cost of a node to the nodes reached through it, see path_set_coords
+ */
+void PathQuery::UpdateChildren(int root)
+{
+	int stackSize = 0;
+	stack[stackSize++] = root;
+	while (stackSize != 0) {
+		const Node &from = nodes[stack[--stackSize]];
+		for (int i = 0; i < from.childCount; i++) {
+			Node &node = nodes[from.children[i]];
+			int nextG = from.g + StepCost(from.x, from.y, node.x, node.y);
+			if (nextG < node.g && CanStep(from, node.x, node.y)) {
+				node.parent = &from - nodes;
+				node.g = nextG;
+				node.f = nextG + node.h;
+				stack[stackSize++] = from.children[i];
+			}
+		}
+	}
+}
+
+int PathQuery::TracePath(int last, std::span<char> steps) const
+{
+	int length = 0;
+	for (int i = last; nodes[i].parent != -1; i = nodes[i].parent) {
+		if (++length == MAX_PATH_LENGTH)
+			return Terminate(steps, 0);
+	}
+
+	int step = length;
+	for (int i = last; nodes[i].parent != -1; i = nodes[i].parent) {
+		const Node &node = nodes[i];
+		const Node &parent = nodes[node.parent];
+		if (--step < (int)steps.size())
+			steps[step] = StepDirection(node.x - parent.x, node.y - parent.y);
+	}
+
+	return Terminate(steps, length);
+}
+
+int PathQuery::Find(Point start, Point goal, std::span<char> steps)
+{
+	if (start.x < 0 || start.x >= MAXDUNX || start.y < 0 || start.y >= MAXDUNY)
+		return Terminate(steps, 0);
+
+	if (++epoch == 0) {
+		std::fill_n(cellEpoch, GridWidth * GridHeight, 0);
+		epoch = 1;
+	}
+	nodeCount = 0;
+	frontier = NewNode(start.x, start.y, goal);
+
+	while (frontier != -1) {
+		int current = frontier;
+		Node &node = nodes[current];
+		frontier = node.next;
+		node.visited = true;
+		if (node.x == goal.x && node.y == goal.y)
+			return TracePath(current, steps);
+		if (!Expand(current, goal))
+			return Terminate(steps, 0);
+	}
+
+	return Terminate(steps, 0);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "../engine.h"
+#include "walkability.h"
+
+/**
+ * The A* search of FindPath over a Walkability, it expands the nodes in the same order
+ * and has the same node and length limits, so it finds the same paths as the game.
+ *
+ * The query owns its nodes, and the positions it has nodes for are told apart from
+ * the ones of earlier searches by an epoch counter, so a search allocates and clears
+ * nothing. Queries share no state, each thread can use its own.
+ */
+class PathQuery {
+public:
+	explicit PathQuery(const Walkability &walkability);
+
+	/**
+	 * @brief Find the shortest path from start to goal, start must be in the dungeon
+	 * @param steps Receives the step directions (see path_directions) as many as fit, followed
+	 * by a 0 if there is room
+	 * @return The number of steps, 0 if there is no path or it is MAX_PATH_LENGTH or longer
+	 */
+	int Find(Point start, Point goal, std::span<char> steps = {});
+
+private:
+	/** FindPath also spends two of its nodes on the heads of its lists */
+	static constexpr int MaxNodes = MAXPATHNODES - 2;
+	/** Positions next to the dungeon get nodes too, when they are the goal */
+	static constexpr int GridWidth = MAXDUNX + 2;
+	static constexpr int GridHeight = MAXDUNY + 2;
+
+	struct Node {
+		int f;
+		int g;
+		int h;
+		int x;
+		int y;
+		int16_t parent;
+		/** Next node on the frontier */
+		int16_t next;
+		int16_t children[8];
+		uint8_t childCount;
+		bool visited;
+	};
+
+	static int CellIndex(int x, int y);
+	int NodeAt(int x, int y) const;
+	int NewNode(int x, int y, Point goal);
+	bool CanStep(const Node &from, int dx, int dy) const;
+	bool Expand(int current, Point goal);
+	bool AddStep(int current, int dx, int dy, Point goal);
+	void InsertFrontier(int current);
+	void UpdateChildren(int root);
+	int TracePath(int last, std::span<char> steps) const;
+
+	const Walkability *walkability;
+	Node nodes[MaxNodes];
+	int nodeCount = 0;
+	int16_t frontier = -1;
+	uint32_t epoch = 0;
+	/** The node of a position is valid if the position was stamped with the current epoch */
+	uint32_t cellEpoch[GridWidth * GridHeight] = {};
+	int16_t cellNode[GridWidth * GridHeight];
+	int16_t stack[MAXPATHNODES];
+};
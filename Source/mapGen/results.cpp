@@ -0,0 +1,108 @@
+#include "results.h"
+
+#include <cstring>
+
+#include "../analyzer/scannerName.h"
+
+namespace {
+
+/** Number of records a thread collects before writing them to the file */
+constexpr size_t ResultBlockSize = 4096;
+
+struct ResultBlock {
+	ResultSink *sink = nullptr;
+	ResultRecord records[ResultBlockSize];
+	size_t size = 0;
+
+	~ResultBlock()
+	{
+		if (sink != nullptr && size != 0)
+			sink->Flush();
+	}
+};
+
+thread_local ResultBlock block;
+
+}  // namespace
+
+std::string FormatTicks(int ticks)
+{
+	float time = (float)ticks / 20;
+	int min = time / 60;
+	char fmt[12];
+	sprintf(fmt, "%u:%05.2lf", min, time - min * 60);
+
+	return fmt;
+}
+
+std::string FormatResult(const ResultRecord &record)
+{
+	std::string gameSeed = std::to_string(record.gameSeed);
+
+	switch (static_cast<Scanners>(record.scanner)) {
+	case Scanners::Path:
+		return gameSeed + " (etc " + FormatTicks(record.metric) + ")";
+	case Scanners::Pattern:
+		if ((record.flags & ResultHasLevelSeed) != 0)
+			return "Level Seed for dlvl " + std::to_string(record.level) + ": " + std::to_string(record.levelSeed);
+		return gameSeed + " possible game Seed for dlvl " + std::to_string(record.level);
+	default:
+		return gameSeed;
+	}
+}
+
+bool ResultSink::Open(const std::string &path)
+{
+	file = fopen(path.c_str(), "wb");
+	if (file == nullptr)
+		return false;
+
+	ResultFileHeader header {};
+	memcpy(header.magic, ResultFileMagic, sizeof(ResultFileMagic));
+	header.version = ResultFileVersion;
+	header.recordSize = sizeof(ResultRecord);
+	fwrite(&header, 1, sizeof(header), file);
+
+	return true;
+}
+
+bool ResultSink::IsOpen() const
+{
+	return file != nullptr;
+}
+
+void ResultSink::Append(const ResultRecord &record)
+{
+	block.sink = this;
+	block.records[block.size++] = record;
+	if (block.size == ResultBlockSize)
+		Flush();
+}
+
+/**
+ * @brief Write the records collected by the calling thread
+ */
+void ResultSink::Flush()
+{
+	WriteRecords(block.records, block.size);
+	block.size = 0;
+}
+
+void ResultSink::WriteRecords(const ResultRecord *records, size_t count)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (file != nullptr)
+		fwrite(records, sizeof(ResultRecord), count, file);
+}
+
+void ResultSink::Close()
+{
+	if (file == nullptr)
+		return;
+
+	Flush();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	fclose(file);
+	file = nullptr;
+}
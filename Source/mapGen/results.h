@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+/**
+ * A match reported by a scanner.
+ */
+struct ResultRecord {
+	uint32_t gameSeed;
+	uint32_t levelSeed;
+	/** Scanner specific value, e.g. the estimated ticks for the path scanner */
+	int32_t metric;
+	uint8_t level;
+	/** Scanners value of the scanner that found the match */
+	uint8_t scanner;
+	uint8_t flags;
+	uint8_t reserved;
+};
+
+constexpr uint8_t ResultHasLevelSeed = 1 << 0;
+
+/**
+ * Result files start with this header followed by the records.
+ */
+struct ResultFileHeader {
+	char magic[4];
+	uint32_t version;
+	uint32_t recordSize;
+	uint32_t reserved;
+};
+
+constexpr char ResultFileMagic[4] = { 'R', 'S', 'L', 'T' };
+constexpr uint32_t ResultFileVersion = 1;
+
+std::string FormatTicks(int ticks);
+/**
+ * @brief Render a record the way the scanners print it to stdout
+ */
+std::string FormatResult(const ResultRecord &record);
+
+/**
+ * Collects records in a block per thread and writes full blocks to a result file,
+ * so threads only synchronize once per block.
+ */
+class ResultSink {
+public:
+	bool Open(const std::string &path);
+	bool IsOpen() const;
+	void Append(const ResultRecord &record);
+	void Flush();
+	void Close();
+
+private:
+	void WriteRecords(const ResultRecord *records, size_t count);
+
+	FILE *file = nullptr;
+	std::mutex mutex;
+};
@@ -0,0 +1,238 @@
+#include "seedList.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+uint32_t ReadLE32(const char *data)
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data);
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+uint64_t ReadLE64(const char *data)
+{
+	return ReadLE32(data) | ((uint64_t)ReadLE32(data + 4) << 32);
+}
+
+size_t WriteLE32(uint8_t *out, uint32_t value)
+{
+	out[0] = value & 0xFF;
+	out[1] = (value >> 8) & 0xFF;
+	out[2] = (value >> 16) & 0xFF;
+	out[3] = value >> 24;
+	return 4;
+}
+
+uint64_t CountLines(const char *data, const char *end)
+{
+	uint64_t lines = 0;
+	while (data < end) {
+		const char *newline = static_cast<const char *>(memchr(data, '\n', end - data));
+		lines++;
+		if (newline == nullptr)
+			break;
+		data = newline + 1;
+	}
+
+	return lines;
+}
+
+}  // namespace
+
+SeedReader::~SeedReader()
+{
+	Close();
+}
+
+bool SeedReader::Open(const std::string &path)
+{
+	Close();
+
+	if (!mapped.Open(path, true))
+		return false;
+
+	const char *data = mapped.Data();
+	size_t size = mapped.Size();
+	cursor = data;
+	end = data + size;
+	line = 0;
+	previous = 0;
+
+	binary = size >= sizeof(SeedListHeader) && memcmp(data, SeedListMagic, sizeof(SeedListMagic)) == 0;
+	if (binary) {
+		varint = (ReadLE32(data + 4) & SeedListVarint) != 0;
+		count = ReadLE64(data + 8);
+		cursor += sizeof(SeedListHeader);
+		if (!varint && count > (size - sizeof(SeedListHeader)) / 4)
+			count = (size - sizeof(SeedListHeader)) / 4;
+	} else {
+		count = CountLines(data, end);
+	}
+
+	return true;
+}
+
+void SeedReader::Close()
+{
+	mapped.Close();
+	cursor = nullptr;
+	end = nullptr;
+	count = 0;
+}
+
+uint64_t SeedReader::Count() const
+{
+	return count;
+}
+
+void SeedReader::Skip(uint64_t seeds)
+{
+	if (binary && !varint) {
+		cursor += std::min(seeds, count) * 4;
+		return;
+	}
+
+	if (varint) {
+		for (uint64_t i = 0; i < seeds && cursor < end; i++)
+			NextVarint();
+		return;
+	}
+
+	for (uint64_t i = 0; i < seeds && cursor < end; i++) {
+		const char *newline = static_cast<const char *>(memchr(cursor, '\n', end - cursor));
+		cursor = newline != nullptr ? newline + 1 : end;
+		line++;
+	}
+}
+
+uint32_t SeedReader::Next()
+{
+	if (!binary)
+		return NextText();
+	if (varint)
+		return NextVarint();
+
+	uint32_t seed = ReadLE32(cursor);
+	cursor += 4;
+	return seed;
+}
+
+uint32_t SeedReader::NextText()
+{
+	line++;
+
+	const char *lineEnd = static_cast<const char *>(memchr(cursor, '\n', end - cursor));
+	if (lineEnd == nullptr)
+		lineEnd = end;
+
+	while (cursor < lineEnd && (*cursor == ' ' || *cursor == '\t'))
+		cursor++;
+
+	int64_t seed;
+	std::from_chars_result result = std::from_chars(cursor, lineEnd, seed);
+	if (result.ec != std::errc()) {
+		std::cerr << "Invalid seed on line " << line << " of the seeds file" << std::endl;
+		exit(255);
+	}
+
+	cursor = lineEnd < end ? lineEnd + 1 : end;
+
+	return static_cast<uint32_t>(seed);
+}
+
+uint32_t SeedReader::NextVarint()
+{
+	uint32_t zigzag = 0;
+	for (int shift = 0; cursor < end && shift < 35; shift += 7) {
+		uint8_t byte = *cursor++;
+		zigzag |= (uint32_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0)
+			break;
+	}
+
+	int32_t delta = (zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+	previous += delta;
+
+	return previous;
+}
+
+SeedWriter::~SeedWriter()
+{
+	Close();
+}
+
+bool SeedWriter::Open(const std::string &path, bool varint)
+{
+	Close();
+
+	file = fopen(path.c_str(), "wb");
+	if (file == nullptr)
+		return false;
+
+	this->varint = varint;
+	count = 0;
+	previous = 0;
+	size = 0;
+
+	SeedListHeader header {};
+	fwrite(&header, 1, sizeof(header), file);
+
+	return true;
+}
+
+bool SeedWriter::IsOpen() const
+{
+	return file != nullptr;
+}
+
+void SeedWriter::Write(uint32_t seed)
+{
+	if (size + 5 > sizeof(buffer))
+		FlushBuffer();
+
+	count++;
+
+	if (!varint) {
+		size += WriteLE32(&buffer[size], seed);
+		return;
+	}
+
+	int32_t delta = static_cast<int32_t>(seed - previous);
+	uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+	previous = seed;
+
+	while (zigzag >= 0x80) {
+		buffer[size++] = (zigzag & 0x7F) | 0x80;
+		zigzag >>= 7;
+	}
+	buffer[size++] = zigzag;
+}
+
+void SeedWriter::FlushBuffer()
+{
+	fwrite(buffer, 1, size, file);
+	size = 0;
+}
+
+void SeedWriter::Close()
+{
+	if (file == nullptr)
+		return;
+
+	FlushBuffer();
+
+	uint8_t header[sizeof(SeedListHeader)];
+	memcpy(header, SeedListMagic, sizeof(SeedListMagic));
+	WriteLE32(&header[4], varint ? SeedListVarint : 0);
+	WriteLE32(&header[8], count & 0xFFFFFFFF);
+	WriteLE32(&header[12], count >> 32);
+	fseek(file, 0, SEEK_SET);
+	fwrite(header, 1, sizeof(header), file);
+
+	fclose(file);
+	file = nullptr;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+
+#include "mappedFile.h"
+
+/**
+ * Binary seed lists start with this header, followed by either little-endian uint32 seeds,
+ * or with SeedListVarint set, the zigzag encoded difference to the previous seed as a LEB128 varint.
+ */
+struct SeedListHeader {
+	char magic[4];
+	uint32_t flags;
+	uint64_t count;
+};
+
+constexpr char SeedListMagic[4] = { 'S', 'E', 'E', 'D' };
+constexpr uint32_t SeedListVarint = 1 << 0;
+
+/**
+ * Streams seeds from a memory mapped seed list, either a text file with one seed at
+ * the start of each line, or a binary seed list.
+ */
+class SeedReader {
+public:
+	~SeedReader();
+
+	bool Open(const std::string &path);
+	uint64_t Count() const;
+	void Skip(uint64_t count);
+	uint32_t Next();
+
+private:
+	void Close();
+	uint32_t NextText();
+	uint32_t NextVarint();
+
+	MappedFile mapped;
+	const char *cursor = nullptr;
+	const char *end = nullptr;
+	uint64_t count = 0;
+	uint64_t line = 0;
+	bool binary = false;
+	bool varint = false;
+	uint32_t previous = 0;
+};
+
+/**
+ * Writes a binary seed list, the header is completed when the writer is closed.
+ */
+class SeedWriter {
+public:
+	~SeedWriter();
+
+	bool Open(const std::string &path, bool varint);
+	bool IsOpen() const;
+	void Write(uint32_t seed);
+	void Close();
+
+private:
+	void FlushBuffer();
+
+	FILE *file = nullptr;
+	bool varint = false;
+	uint64_t count = 0;
+	uint32_t previous = 0;
+	uint8_t buffer[64 * 1024];
+	size_t size = 0;
+};
@@ -0,0 +1,60 @@
+#include "tileRules.h"
+
+extern bool oobread;
+extern bool oobwrite;
+
+namespace {
+
+constexpr unsigned GridSize = DMAXX * DMAXY;
+
+template <TileAccess Access>
+BYTE ReadTile(const BYTE *cells, int p)
+{
+	if (Access == TileAccess::Checked && (unsigned)p >= GridSize) {
+		oobread = true;
+		return 0;
+	}
+	return cells[p];
+}
+
+template <TileAccess Access>
+void WriteTile(BYTE *cells, int p, BYTE tile)
+{
+	if (Access == TileAccess::Checked && (unsigned)p >= GridSize) {
+		oobwrite = true;
+		return;
+	}
+	cells[p] = tile;
+}
+
+template <TileAccess Access>
+void ApplyPass(const uint16_t *first, const CompiledTileRule *rules, BYTE *cells, int x1, int y1)
+{
+	for (int y = y1; y < DMAXY; y++) {
+		for (int x = x1; x < DMAXX; x++) {
+			int p = x * DMAXY + y;
+			BYTE centre = cells[p];
+			int end = first[centre + 1];
+			for (int r = first[centre]; r < end; r++) {
+				const CompiledTileRule &rule = rules[r];
+				bool match = true;
+				for (int c = 0; c < rule.checkCount && match; c++) {
+					bool equal = ReadTile<Access>(cells, p + rule.offsets[c]) == rule.tiles[c];
+					match = equal != (((rule.notEqual >> c) & 1) != 0);
+				}
+				if (match)
+					WriteTile<Access>(cells, p + rule.writeOffset, rule.writeTile);
+			}
+		}
+	}
+}
+
+}  // namespace
+
+void ApplyTileRules(const uint16_t *first, const CompiledTileRule *rules, BYTE (*grid)[DMAXY], TileAccess access, int x1, int y1)
+{
+	if (access == TileAccess::Checked)
+		ApplyPass<TileAccess::Checked>(first, rules, &grid[0][0], x1, y1);
+	else
+		ApplyPass<TileAccess::Unchecked>(first, rules, &grid[0][0], x1, y1);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../types.h"
+
+/**
+ * Neighbour rewrite rules of the tile fix passes of the level generators.
+ *
+ * A pass visits the tiles in rows, and for each tile tries the rules whose centre is
+ * that tile in the order they are listed. A rule compares some neighbours of the tile
+ * and when they all match it replaces one of them. Rules never change the centre tile,
+ * so only the rules of the tile found at the start of the visit can match.
+ */
+
+/** A tile compared by a rule, relative to the centre tile */
+struct TileCheck {
+	int8_t dx;
+	int8_t dy;
+	uint8_t tile;
+	/** Match any tile except tile */
+	bool notEqual = false;
+};
+
+/** A tile replaced by a rule, relative to the centre tile */
+struct TileWrite {
+	int8_t dx;
+	int8_t dy;
+	uint8_t tile;
+};
+
+struct TileRule {
+	uint8_t centre;
+	/** Compared in order, the checks after the last used one are left at (0, 0) */
+	TileCheck checks[3];
+	TileWrite write;
+};
+
+/** A rule with its positions as offsets into the grid flattened column by column */
+struct CompiledTileRule {
+	int16_t offsets[3];
+	uint8_t tiles[3];
+	uint8_t checkCount;
+	/** Bit n is set if check n is a notEqual check */
+	uint8_t notEqual;
+	int16_t writeOffset;
+	uint8_t writeTile;
+};
+
+/**
+ * Rules of a pass grouped by their centre tile, the rules of tile t are
+ * rules[first[t]] to rules[first[t + 1] - 1]
+ */
+template <size_t N>
+struct TileRuleTable {
+	std::array<uint16_t, 257> first;
+	std::array<CompiledTileRule, N> rules;
+};
+
+enum class TileAccess : uint8_t {
+	/** Out of bounds neighbours read as 0 and are not written, like GetDungeon and SetDungeon */
+	Checked,
+	/** Neighbours are not bounds checked, for the passes that index the grid directly */
+	Unchecked,
+};
+
+template <size_t N>
+constexpr TileRuleTable<N> CompileTileRules(const TileRule (&rules)[N])
+{
+	static_assert(N < UINT16_MAX);
+
+	TileRuleTable<N> table {};
+	size_t n = 0;
+	for (int tile = 0; tile < 256; tile++) {
+		table.first[tile] = n;
+		for (const TileRule &rule : rules) {
+			if (rule.centre != tile)
+				continue;
+
+			CompiledTileRule &compiled = table.rules[n++];
+			for (const TileCheck &check : rule.checks) {
+				if (check.dx == 0 && check.dy == 0)
+					break;
+				compiled.offsets[compiled.checkCount] = check.dx * DMAXY + check.dy;
+				compiled.tiles[compiled.checkCount] = check.tile;
+				if (check.notEqual)
+					compiled.notEqual |= 1 << compiled.checkCount;
+				compiled.checkCount++;
+			}
+			compiled.writeOffset = rule.write.dx * DMAXY + rule.write.dy;
+			compiled.writeTile = rule.write.tile;
+		}
+	}
+	table.first[256] = n;
+
+	return table;
+}
+
+void ApplyTileRules(const uint16_t *first, const CompiledTileRule *rules, BYTE (*grid)[DMAXY], TileAccess access, int x1, int y1);
+
+/**
+ * @brief Run a pass over the tiles from (x1, y1) to the end of the grid
+ */
+template <size_t N>
+void ApplyTileRules(const TileRuleTable<N> &table, BYTE (*grid)[DMAXY], TileAccess access, int x1 = 0, int y1 = 0)
+{
+	ApplyTileRules(table.first.data(), table.rules.data(), grid, access, x1, y1);
+}
@@ -0,0 +1,80 @@
+#include "walkability.h"
+
+#include <cstdlib>
+
+#include "../engine.h"
+
+void Walkability::Invalidate()
+{
+	valid = false;
+}
+
+bool Walkability::IsValid() const
+{
+	return valid;
+}
+
+void Walkability::Select(Doors doors, Breakables breakables)
+{
+	selectedSolid = solid[doors];
+	selectedBlocked = blocked[doors][breakables];
+}
+
+bool Walkability::Test(const Row *rows, int x, int y)
+{
+	return (rows[x].words[y / 64] >> (y % 64)) & 1;
+}
+
+bool Walkability::IsSolid(int x, int y) const
+{
+	if (x < 0 || x >= MAXDUNX || y < 0 || y >= MAXDUNY)
+		return true;
+
+	return Test(selectedSolid, x, y);
+}
+
+bool Walkability::IsWalkable(int x, int y) const
+{
+	if (x < 0 || x >= MAXDUNX || y < 0 || y >= MAXDUNY)
+		return false;
+
+	return !Test(selectedBlocked, x, y);
+}
+
+void InitPathWalkability(Walkability &walkability)
+{
+	static const int L1Doors[] = { 44, 46, 51, 56, 214, 270 };
+	static const int L2Doors[] = { 55, 58, 538, 540 };
+	static const int L3Doors[] = { 531, 534 };
+	BOOLEAN doorPieces[MAXTILES + 1] = {};
+
+	switch (leveltype) {
+	case DTYPE_CATHEDRAL:
+		for (int piece : L1Doors)
+			doorPieces[piece] = TRUE;
+		break;
+	case DTYPE_CATACOMBS:
+		for (int piece : L2Doors)
+			doorPieces[piece] = TRUE;
+		break;
+	case DTYPE_CAVES:
+		for (int piece : L3Doors)
+			doorPieces[piece] = TRUE;
+		break;
+	}
+
+	walkability.Build([&](int x, int y) {
+		int piece = dPiece[x][y];
+		uint8_t flags = 0;
+		if (piece == 0)
+			flags |= Walkability::TileEmpty;
+		if (nSolidTable[piece])
+			flags |= doorPieces[piece] ? Walkability::TileDoor : Walkability::TileSolid;
+		if (dObject[x][y] != 0) {
+			ObjectStruct *obj = &object[std::abs(dObject[x][y]) - 1];
+			if (obj->_oSolidFlag)
+				flags |= obj->_oBreak ? Walkability::TileObject | Walkability::TileBreakable : Walkability::TileObject;
+		}
+		return flags;
+	});
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+
+#include "../../types.h"
+
+/**
+ * One bit per tile telling if the player can stand there, for the path checks of the
+ * analyzers.
+ *
+ * The bitmaps of all door and breakable object states are built together, Select()
+ * picks the one the queries use, so the checks are a single bit test and opening the
+ * doors does not touch the solidity tables of the level.
+ *
+ * The bitmaps are only valid between Build() and Invalidate().
+ */
+class Walkability {
+public:
+	enum Doors : uint8_t {
+		DoorsClosed,
+		DoorsOpen,
+		DoorStates,
+	};
+
+	enum Breakables : uint8_t {
+		/** Breakable objects are solid */
+		BreakablesBlock,
+		/** Breakable objects can be walked through */
+		BreakablesPass,
+		BreakableStates,
+	};
+
+	/** What a tile holds, as reported to Build() */
+	enum TileFlags : uint8_t {
+		/** No piece */
+		TileEmpty = 1 << 0,
+		TileSolid = 1 << 1,
+		/** Solid only while the doors are closed */
+		TileDoor = 1 << 2,
+		/** Solid object */
+		TileObject = 1 << 3,
+		/** Solid object that can be broken */
+		TileBreakable = 1 << 4,
+	};
+
+	template <typename Predicate>
+	void Build(Predicate tileFlags);
+	void Invalidate();
+	bool IsValid() const;
+	void Select(Doors doors, Breakables breakables);
+	/**
+	 * @brief The piece at (x, y) blocks movement, regardless of objects
+	 */
+	bool IsSolid(int x, int y) const;
+	/**
+	 * @brief The player can stand at (x, y)
+	 */
+	bool IsWalkable(int x, int y) const;
+
+private:
+	static constexpr int RowWords = (MAXDUNY + 63) / 64;
+
+	/** The tiles of a column, bit y of the row is tile (x, y) */
+	struct Row {
+		uint64_t words[RowWords];
+	};
+
+	static bool Test(const Row *rows, int x, int y);
+
+	Row solid[DoorStates][MAXDUNX];
+	Row blocked[DoorStates][BreakableStates][MAXDUNX];
+	const Row *selectedSolid = solid[DoorsClosed];
+	const Row *selectedBlocked = blocked[DoorsClosed][BreakablesBlock];
+	bool valid = false;
+};
+
+/**
+ * @brief Build the walkability of the current level from its pieces, doors and objects
+ */
+void InitPathWalkability(Walkability &walkability);
+
+template <typename Predicate>
+void Walkability::Build(Predicate tileFlags)
+{
+	for (int x = 0; x < MAXDUNX; x++) {
+		for (int i = 0; i < RowWords; i++) {
+			uint64_t empty = 0;
+			uint64_t solidPieces = 0;
+			uint64_t doors = 0;
+			uint64_t objects = 0;
+			uint64_t breakables = 0;
+			for (int bit = 0; bit < 64 && i * 64 + bit < MAXDUNY; bit++) {
+				uint8_t flags = tileFlags(x, i * 64 + bit);
+				empty |= (uint64_t)((flags & TileEmpty) != 0) << bit;
+				solidPieces |= (uint64_t)((flags & TileSolid) != 0) << bit;
+				doors |= (uint64_t)((flags & TileDoor) != 0) << bit;
+				objects |= (uint64_t)((flags & TileObject) != 0) << bit;
+				breakables |= (uint64_t)((flags & TileBreakable) != 0) << bit;
+			}
+
+			solid[DoorsClosed][x].words[i] = solidPieces | doors;
+			solid[DoorsOpen][x].words[i] = solidPieces;
+			for (int d = 0; d < DoorStates; d++) {
+				uint64_t pieces = empty | solid[d][x].words[i];
+				blocked[d][BreakablesBlock][x].words[i] = pieces | objects;
+				blocked[d][BreakablesPass][x].words[i] = pieces | (objects & ~breakables);
+			}
+		}
+	}
+
+	valid = true;
+}
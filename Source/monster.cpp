@@ -5,6 +5,8 @@
  */
 #include "all.h"
 
+#include "mapGen/freeCells.h"
+
 /** Tracks which missile files are already loaded */
 int MissileFileFlag;
 
@@ -542,6 +544,21 @@ BOOL MonstPlace(int xp, int yp)
 	return !SolidLoc(xp, yp);
 }
 
+namespace {
+
+/** Tiles where MonstPlace holds while InitMonsters runs, kept up to date as monsters are placed */
+FreeCells monsterCells;
+
+BOOL MonstPlaceFast(int xp, int yp)
+{
+	if (monsterCells.IsValid())
+		return monsterCells.IsFree(FreeCells::AreaTile, xp, yp);
+
+	return MonstPlace(xp, yp);
+}
+
+}  // namespace
+
 #ifdef HELLFIRE
 void monster_some_crypt()
 {
@@ -578,6 +595,8 @@ void PlaceMonster(int i, int mtype, int x, int y)
 	}
 #endif
 	dMonster[x][y] = i + 1;
+	dirtyGrids |= DIRTY_MONSTER;
+	monsterCells.Update(x, y, x, y, MonstPlace);
 
 	rd = random_(90, 8);
 	InitMonster(i, rd, mtype, x, y);
@@ -613,10 +632,14 @@ void PlaceUniqueMonst(int uniqindex, int miniontype, int bosspacksize)
 		xp = random_(91, 80) + 16;
 		yp = random_(91, 80) + 16;
 		count2 = 0;
-		for (x = xp - 3; x < xp + 3; x++) {
-			for (y = yp - 3; y < yp + 3; y++) {
-				if (y >= 0 && y < MAXDUNY && x >= 0 && x < MAXDUNX && MonstPlace(x, y)) {
-					count2++;
+		if (monsterCells.IsValid()) {
+			count2 = monsterCells.Count(xp - 3, yp - 3, xp + 2, yp + 2);
+		} else {
+			for (x = xp - 3; x < xp + 3; x++) {
+				for (y = yp - 3; y < yp + 3; y++) {
+					if (y >= 0 && y < MAXDUNY && x >= 0 && x < MAXDUNX && MonstPlace(x, y)) {
+						count2++;
+					}
 				}
 			}
 		}
@@ -628,7 +651,7 @@ void PlaceUniqueMonst(int uniqindex, int miniontype, int bosspacksize)
 			}
 		}
 
-		if (MonstPlace(xp, yp)) {
+		if (MonstPlaceFast(xp, yp)) {
 			break;
 		}
 	}
@@ -869,27 +892,27 @@ void PlaceQuestMonsters()
 		}
 
 		if (QuestStatus(Q_LTBANNER)) {
-			setp = LoadFileInMem("Levels\\L1Data\\Banner1.DUN", NULL);
+			setp = LoadLevelFileInMem("Levels\\L1Data\\Banner1.DUN", NULL);
 			SetMapMonsters(setp, 2 * setpc_x, 2 * setpc_y);
 			mem_free_dbg(setp);
 		}
 		if (QuestStatus(Q_BLOOD)) {
-			setp = LoadFileInMem("Levels\\L2Data\\Blood2.DUN", NULL);
+			setp = LoadLevelFileInMem("Levels\\L2Data\\Blood2.DUN", NULL);
 			SetMapMonsters(setp, 2 * setpc_x, 2 * setpc_y);
 			mem_free_dbg(setp);
 		}
 		if (QuestStatus(Q_BLIND)) {
-			setp = LoadFileInMem("Levels\\L2Data\\Blind2.DUN", NULL);
+			setp = LoadLevelFileInMem("Levels\\L2Data\\Blind2.DUN", NULL);
 			SetMapMonsters(setp, 2 * setpc_x, 2 * setpc_y);
 			mem_free_dbg(setp);
 		}
 		if (QuestStatus(Q_ANVIL)) {
-			setp = LoadFileInMem("Levels\\L3Data\\Anvil.DUN", NULL);
+			setp = LoadLevelFileInMem("Levels\\L3Data\\Anvil.DUN", NULL);
 			SetMapMonsters(setp, 2 * setpc_x + 2, 2 * setpc_y + 2);
 			mem_free_dbg(setp);
 		}
 		if (QuestStatus(Q_WARLORD)) {
-			setp = LoadFileInMem("Levels\\L4Data\\Warlord.DUN", NULL);
+			setp = LoadLevelFileInMem("Levels\\L4Data\\Warlord.DUN", NULL);
 			SetMapMonsters(setp, 2 * setpc_x, 2 * setpc_y);
 			mem_free_dbg(setp);
 			AddMonsterType(UniqMonst[UMT_WARLORD].mtype, PLACE_SCATTER);
@@ -907,7 +930,7 @@ void PlaceQuestMonsters()
 			PlaceUniqueMonst(UMT_LAZURUS, 0, 0);
 			PlaceUniqueMonst(UMT_RED_VEX, 0, 0);
 			PlaceUniqueMonst(UMT_BLACKJADE, 0, 0);
-			setp = LoadFileInMem("Levels\\L4Data\\Vile1.DUN", NULL);
+			setp = LoadLevelFileInMem("Levels\\L4Data\\Vile1.DUN", NULL);
 			SetMapMonsters(setp, 2 * setpc_x, 2 * setpc_y);
 			mem_free_dbg(setp);
 		}
@@ -951,6 +974,7 @@ void PlaceGroup(int mtype, int num, int leaderf, int leader)
 			nummonsters--;
 			placed--;
 			dMonster[monster[nummonsters]._mx][monster[nummonsters]._my] = 0;
+			monsterCells.Update(monster[nummonsters]._mx, monster[nummonsters]._my, monster[nummonsters]._mx, monster[nummonsters]._my, MonstPlace);
 		}
 
 		if (leaderf & 1) {
@@ -961,7 +985,7 @@ void PlaceGroup(int mtype, int num, int leaderf, int leader)
 			do {
 				x1 = xp = random_(93, 80) + 16;
 				y1 = yp = random_(93, 80) + 16;
-			} while (!MonstPlace(xp, yp));
+			} while (!MonstPlaceFast(xp, yp));
 		}
 
 		if (num + nummonsters > totalmonsters) {
@@ -970,7 +994,7 @@ void PlaceGroup(int mtype, int num, int leaderf, int leader)
 
 		j = 0;
 		for (try2 = 0; j < num && try2 < 100; xp += offset_x[random_(94, 8)], yp += offset_x[random_(94, 8)]) { /// BUGFIX: `yp += offset_y`
-			if (!MonstPlace(xp, yp)
+			if (!MonstPlaceFast(xp, yp)
 			    || (dTransVal[xp][yp] != dTransVal[x1][y1])
 			    || (leaderf & 2) && ((abs(xp - x1) >= 4) || (abs(yp - y1) >= 4))) {
 				try2++;
@@ -1016,16 +1040,16 @@ void LoadDiabMonsts()
 {
 	BYTE *lpSetPiece;
 
-	lpSetPiece = LoadFileInMem("Levels\\L4Data\\diab1.DUN", NULL);
+	lpSetPiece = LoadLevelFileInMem("Levels\\L4Data\\diab1.DUN", NULL);
 	SetMapMonsters(lpSetPiece, 2 * diabquad1x, 2 * diabquad1y);
 	mem_free_dbg(lpSetPiece);
-	lpSetPiece = LoadFileInMem("Levels\\L4Data\\diab2a.DUN", NULL);
+	lpSetPiece = LoadLevelFileInMem("Levels\\L4Data\\diab2a.DUN", NULL);
 	SetMapMonsters(lpSetPiece, 2 * diabquad2x, 2 * diabquad2y);
 	mem_free_dbg(lpSetPiece);
-	lpSetPiece = LoadFileInMem("Levels\\L4Data\\diab3a.DUN", NULL);
+	lpSetPiece = LoadLevelFileInMem("Levels\\L4Data\\diab3a.DUN", NULL);
 	SetMapMonsters(lpSetPiece, 2 * diabquad3x, 2 * diabquad3y);
 	mem_free_dbg(lpSetPiece);
-	lpSetPiece = LoadFileInMem("Levels\\L4Data\\diab4a.DUN", NULL);
+	lpSetPiece = LoadLevelFileInMem("Levels\\L4Data\\diab4a.DUN", NULL);
 	SetMapMonsters(lpSetPiece, 2 * diabquad4x, 2 * diabquad4y);
 	mem_free_dbg(lpSetPiece);
 }
@@ -1054,12 +1078,9 @@ void InitMonsters()
 	nt = numtrigs;
 	if (currlevel == 15)
 		nt = 1;
-	for (i = 0; i < nt; i++) {
-		for (s = -2; s < 2; s++) {
-			for (t = -2; t < 2; t++)
-				DoVision(s + trigs[i]._tx, t + trigs[i]._ty, 15, FALSE, FALSE);
-		}
-	}
+	for (i = 0; i < nt; i++)
+		DoVisionBlock(trigs[i]._tx, trigs[i]._ty, 15);
+	monsterCells.Build(MonstPlace);
 #ifndef SPAWN
 	PlaceQuestMonsters();
 #endif
@@ -1099,12 +1120,9 @@ void InitMonsters()
 			PlaceGroup(mtype, na, 0, 0);
 		}
 	}
-	for (i = 0; i < nt; i++) {
-		for (s = -2; s < 2; s++) {
-			for (t = -2; t < 2; t++)
-				DoUnVision(s + trigs[i]._tx, t + trigs[i]._ty, 15);
-		}
-	}
+	for (i = 0; i < nt; i++)
+		DoUnVisionBlock(trigs[i]._tx, trigs[i]._ty, 15);
+	monsterCells.Invalidate();
 }
 
 #ifndef SPAWN
@@ -1163,8 +1181,11 @@ int AddMonster(int x, int y, int dir, int mtype, BOOL InMap)
 {
 	if (nummonsters < MAXMONSTERS) {
 		int i = monstactive[nummonsters++];
-		if (InMap)
+		if (InMap) {
 			dMonster[x][y] = i + 1;
+			dirtyGrids |= DIRTY_MONSTER;
+			monsterCells.Update(x, y, x, y, MonstPlace);
+		}
 		InitMonster(i, dir, mtype, x, y);
 		return i;
 	}
@@ -1379,6 +1400,8 @@ BOOL IsGoat(int mt)
 void ActivateSpawn(int i, int x, int y, int dir)
 {
 	dMonster[x][y] = i + 1;
+	dirtyGrids |= DIRTY_MONSTER;
+	monsterCells.Update(x, y, x, y, MonstPlace);
 	monster[i]._mx = x;
 	monster[i]._my = y;
 	monster[i]._mfutx = x;
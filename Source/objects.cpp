@@ -5,6 +5,8 @@
  */
 #include "all.h"
 
+#include "mapGen/freeCells.h"
+
 int trapid;
 int trapdir;
 BYTE *pObjCels[40];
@@ -232,6 +234,24 @@ DIABOOL RndLocOk(int xp, int yp)
 	return FALSE;
 }
 
+namespace {
+
+/** Tiles where RndLocOk holds, built on first use in InitObjects and kept up to date by AddObject */
+FreeCells objectCells;
+
+/**
+ * @brief Same as testing RndLocOk for every tile of the area around the given position
+ */
+DIABOOL RndLocAreaOk(FreeCells::Area area, int xp, int yp)
+{
+	if (!objectCells.IsValid())
+		objectCells.Build(RndLocOk);
+
+	return objectCells.IsFree(area, xp, yp);
+}
+
+}  // namespace
+
 static DIABOOL WallTrapLocOkK(int xp, int yp)
 {
 	if (dFlags[xp][yp] & BFLAG_POPULATED)
@@ -253,15 +273,7 @@ void InitRndLocObj(int min, int max, int objtype)
 		while (1) {
 			xp = random_(139, 80) + 16;
 			yp = random_(139, 80) + 16;
-			if (RndLocOk(xp - 1, yp - 1)
-			    && RndLocOk(xp, yp - 1)
-			    && RndLocOk(xp + 1, yp - 1)
-			    && RndLocOk(xp - 1, yp)
-			    && RndLocOk(xp, yp)
-			    && RndLocOk(xp + 1, yp)
-			    && RndLocOk(xp - 1, yp + 1)
-			    && RndLocOk(xp, yp + 1)
-			    && RndLocOk(xp + 1, yp + 1)) {
+			if (RndLocAreaOk(FreeCells::Area3x3, xp, yp)) {
 				AddObject(objtype, xp, yp);
 				break;
 			}
@@ -278,18 +290,7 @@ void InitRndLocBigObj(int min, int max, int objtype)
 		while (1) {
 			xp = random_(140, 80) + 16;
 			yp = random_(140, 80) + 16;
-			if (RndLocOk(xp - 1, yp - 2)
-			    && RndLocOk(xp, yp - 2)
-			    && RndLocOk(xp + 1, yp - 2)
-			    && RndLocOk(xp - 1, yp - 1)
-			    && RndLocOk(xp, yp - 1)
-			    && RndLocOk(xp + 1, yp - 1)
-			    && RndLocOk(xp - 1, yp)
-			    && RndLocOk(xp, yp)
-			    && RndLocOk(xp + 1, yp)
-			    && RndLocOk(xp - 1, yp + 1)
-			    && RndLocOk(xp, yp + 1)
-			    && RndLocOk(xp + 1, yp + 1)) {
+			if (RndLocAreaOk(FreeCells::Area3x4, xp, yp)) {
 				AddObject(objtype, xp, yp);
 				break;
 			}
@@ -300,22 +301,16 @@ void InitRndLocBigObj(int min, int max, int objtype)
 void InitRndLocObj5x5(int min, int max, int objtype)
 {
 	DIABOOL exit;
-	int xp, yp, numobjs, i, cnt, m, n;
+	int xp, yp, numobjs, i, cnt;
 
 	numobjs = min + random_(139, max - min);
 	for (i = 0; i < numobjs; i++) {
 		cnt = 0;
 		exit = FALSE;
 		while (!exit) {
-			exit = TRUE;
 			xp = random_(139, 80) + 16;
 			yp = random_(139, 80) + 16;
-			for (n = -2; n <= 2; n++) {
-				for (m = -2; m <= 2; m++) {
-					if (!RndLocOk(xp + m, yp + n))
-						exit = FALSE;
-				}
-			}
+			exit = RndLocAreaOk(FreeCells::Area5x5, xp, yp);
 			if (!exit) {
 				cnt++;
 				if (cnt > 20000)
@@ -328,12 +323,14 @@ void InitRndLocObj5x5(int min, int max, int objtype)
 
 void ClrAllObjects()
 {
-	int i;
+	int i, oi;
 
 #ifdef HELLFIRE
 	memset(object, 0, sizeof(object));
 #else
-	for (i = 0; i < MAXOBJECTS; i++) {
+	// Objects are never deleted while generating, so only the active ones can have been set up
+	for (oi = 0; oi < nobjects; oi++) {
+		i = objectactive[oi];
 		object[i]._ox = 0;
 		object[i]._oy = 0;
 		object[i]._oAnimData = 0;
@@ -401,20 +398,14 @@ void AddCandles()
 void AddBookLever(int lx1, int ly1, int lx2, int ly2, int x1, int y1, int x2, int y2, int msg)
 {
 	DIABOOL exit;
-	int xp, yp, ob, cnt, m, n;
+	int xp, yp, ob, cnt;
 
 	cnt = 0;
 	exit = FALSE;
 	while (!exit) {
-		exit = TRUE;
 		xp = random_(139, 80) + 16;
 		yp = random_(139, 80) + 16;
-		for (n = -2; n <= 2; n++) {
-			for (m = -2; m <= 2; m++) {
-				if (!RndLocOk(xp + m, yp + n))
-					exit = FALSE;
-			}
-		}
+		exit = RndLocAreaOk(FreeCells::Area5x5, xp, yp);
 		if (!exit) {
 			cnt++;
 			if (cnt > 20000)
@@ -455,7 +446,7 @@ void InitRndBarrels()
 		do {
 			xp = random_(143, 80) + 16;
 			yp = random_(143, 80) + 16;
-		} while (!RndLocOk(xp, yp));
+		} while (!RndLocAreaOk(FreeCells::AreaTile, xp, yp));
 		o = (random_(143, 4) != 0) ? OBJ_BARREL : OBJ_BARRELEX;
 		AddObject(o, xp, yp);
 		found = TRUE;
@@ -470,7 +461,7 @@ void InitRndBarrels()
 				dir = random_(143, 8);
 				xp += bxadd[dir];
 				yp += byadd[dir];
-				found = RndLocOk(xp, yp);
+				found = RndLocAreaOk(FreeCells::AreaTile, xp, yp);
 				t++;
 				if (found)
 					break;
@@ -744,13 +735,13 @@ void AddDiabObjs()
 {
 	BYTE *lpSetPiece;
 
-	lpSetPiece = LoadFileInMem("Levels\\L4Data\\diab1.DUN", NULL);
+	lpSetPiece = LoadLevelFileInMem("Levels\\L4Data\\diab1.DUN", NULL);
 	LoadMapObjects(lpSetPiece, 2 * diabquad1x, 2 * diabquad1y, diabquad2x, diabquad2y, 11, 12, 1);
 	mem_free_dbg(lpSetPiece);
-	lpSetPiece = LoadFileInMem("Levels\\L4Data\\diab2a.DUN", NULL);
+	lpSetPiece = LoadLevelFileInMem("Levels\\L4Data\\diab2a.DUN", NULL);
 	LoadMapObjects(lpSetPiece, 2 * diabquad2x, 2 * diabquad2y, diabquad3x, diabquad3y, 11, 11, 2);
 	mem_free_dbg(lpSetPiece);
-	lpSetPiece = LoadFileInMem("Levels\\L4Data\\diab3a.DUN", NULL);
+	lpSetPiece = LoadLevelFileInMem("Levels\\L4Data\\diab3a.DUN", NULL);
 	LoadMapObjects(lpSetPiece, 2 * diabquad3x, 2 * diabquad3y, diabquad4x, diabquad4y, 9, 9, 3);
 	mem_free_dbg(lpSetPiece);
 }
@@ -872,13 +863,13 @@ void AddHookedBodies(int freq)
 		jj = 16 + j * 2;
 		for (i = 0; i < DMAXX; i++) {
 			ii = 16 + i * 2;
-			if (GetDungeon(i, j) != 1 && GetDungeon(i, j) != 2)
+			if (dungeon[i][j] != 1 && dungeon[i][j] != 2)
 				continue;
 			if (random_(0, freq) != 0)
 				continue;
 			if (!SkipThemeRoom(i, j))
 				continue;
-			if (GetDungeon(i, j) == 1 && GetDungeon(i + 1, j) == 6) {
+			if (dungeon[i][j] == 1 && GetDungeon(i + 1, j) == 6) {
 				switch (random_(0, 3)) {
 				case 0:
 					AddObject(OBJ_TORTURE1, ii + 1, jj);
@@ -892,7 +883,7 @@ void AddHookedBodies(int freq)
 				}
 				continue;
 			}
-			if (GetDungeon(i, j) == 2 && GetDungeon(i, j + 1) == 6) {
+			if (dungeon[i][j] == 2 && GetDungeon(i, j + 1) == 6) {
 				switch (random_(0, 2)) {
 				case 0:
 					AddObject(OBJ_TORTURE3, ii, jj);
@@ -964,6 +955,7 @@ void InitObjects()
 	BYTE *mem;
 
 	ClrAllObjects();
+	objectCells.Invalidate();
 #ifdef HELLFIRE
 	dword_6DE0E0 = 0;
 #endif
@@ -1041,7 +1033,7 @@ void InitObjects()
 				}
 				quests[Q_BLIND]._qmsg = sp_id;
 				AddBookLever(0, 0, MAXDUNX, MAXDUNY, setpc_x, setpc_y, setpc_w + setpc_x + 1, setpc_h + setpc_y + 1, sp_id);
-				mem = LoadFileInMem("Levels\\L2Data\\Blind2.DUN", NULL);
+				mem = LoadLevelFileInMem("Levels\\L2Data\\Blind2.DUN", NULL);
 				// BUGFIX: should not invoke LoadMapObjs for Blind2.DUN, as Blind2.DUN is missing an objects layer.
 				LoadMapObjs(mem, 2 * setpc_x, 2 * setpc_y);
 				mem_free_dbg(mem);
@@ -1091,7 +1083,7 @@ void InitObjects()
 				}
 				quests[Q_WARLORD]._qmsg = sp_id;
 				AddBookLever(0, 0, MAXDUNX, MAXDUNY, setpc_x, setpc_y, setpc_x + setpc_w, setpc_y + setpc_h, sp_id);
-				mem = LoadFileInMem("Levels\\L4Data\\Warlord.DUN", NULL);
+				mem = LoadLevelFileInMem("Levels\\L4Data\\Warlord.DUN", NULL);
 				LoadMapObjs(mem, 2 * setpc_x, 2 * setpc_y);
 				mem_free_dbg(mem);
 			}
@@ -1109,6 +1101,7 @@ void InitObjects()
 			AddChestTraps();
 		InitObjFlag = FALSE;
 	}
+	objectCells.Invalidate();
 }
 
 #ifndef SPAWN
@@ -1590,6 +1583,7 @@ void AddMushPatch()
 	if (nobjects < MAXOBJECTS) {
 		i = objectavail[0];
 		GetRndObjLoc(5, x, y);
+		dirtyGrids |= DIRTY_OBJECT;
 		dObject[x + 1][y + 1] = -1 - i;
 		dObject[x + 2][y + 1] = -1 - i;
 		dObject[x + 1][y + 2] = -1 - i;
@@ -1617,10 +1611,12 @@ void AddCryptBook(int ot, int v2, int ox, int oy)
 	objectavail[0] = objectavail[MAXOBJECTS - 1 - nobjects];
 	objectactive[nobjects] = oi;
 	dObject[ox][oy] = oi + 1;
+	dirtyGrids |= DIRTY_OBJECT;
 	SetupObject(oi, ox, oy, ot);
 	AddCryptObject(oi, v2);
 	object[oi]._oAnimWidth2 = (object[oi]._oAnimWidth - 64) >> 1;
 	nobjects++;
+	objectCells.Update(ox, oy, ox, oy, RndLocOk);
 }
 
 void AddCryptObject(int i, int a2)
@@ -1704,6 +1700,7 @@ void AddObject(int ot, int ox, int oy)
 	objectavail[0] = objectavail[MAXOBJECTS - 1 - nobjects];
 	objectactive[nobjects] = oi;
 	dObject[ox][oy] = oi + 1;
+	dirtyGrids |= DIRTY_OBJECT;
 	SetupObject(oi, ox, oy, ot);
 	switch (ot) {
 	case OBJ_L1LIGHT:
@@ -1832,6 +1829,8 @@ void AddObject(int ot, int ox, int oy)
 	}
 	object[oi]._oAnimWidth2 = (object[oi]._oAnimWidth - 64) >> 1;
 	nobjects++;
+	// Besides its own tile an object can claim the tiles above and to the left of it
+	objectCells.Update(ox - 1, oy - 1, ox, oy, RndLocOk);
 }
 
 void ObjSetMicro(int dx, int dy, int pn)
@@ -1841,6 +1840,7 @@ void ObjSetMicro(int dx, int dy, int pn)
 	int i;
 
 	dPiece[dx][dy] = pn;
+#ifndef GENERATION_ONLY
 	pn--;
 	defs = &dpiece_defs_map_1[IsometricCoord(dx, dy)];
 	if (leveltype != DTYPE_HELL) {
@@ -1854,10 +1854,12 @@ void ObjSetMicro(int dx, int dy, int pn)
 			defs->mt[i] = v[(i & 1) - (i & 0xE) + 14];
 		}
 	}
+#endif
 }
 
 void objects_set_door_piece(int x, int y)
 {
+#ifndef GENERATION_ONLY
 	int pn;
 	long v1, v2;
 
@@ -1884,6 +1886,7 @@ void objects_set_door_piece(int x, int y)
 #endif
 	dpiece_defs_map_1[IsometricCoord(x, y)].mt[0] = v1;
 	dpiece_defs_map_1[IsometricCoord(x, y)].mt[1] = v2;
+#endif
 }
 
 void ObjSetMini(int x, int y, int v)
@@ -1930,6 +1933,7 @@ void ObjSetMini(int x, int y, int v)
 
 void ObjL1Special(int x1, int y1, int x2, int y2)
 {
+#ifndef GENERATION_ONLY
 	int i, j;
 
 	for (i = y1; i <= y2; ++i) {
@@ -1965,10 +1969,12 @@ void ObjL1Special(int x1, int y1, int x2, int y2)
 				dSpecial[j][i] = 2;
 		}
 	}
+#endif
 }
 
 void ObjL2Special(int x1, int y1, int x2, int y2)
 {
+#ifndef GENERATION_ONLY
 	int i, j;
 
 	for (j = y1; j <= y2; j++) {
@@ -2002,6 +2008,7 @@ void ObjL2Special(int x1, int y1, int x2, int y2)
 			}
 		}
 	}
+#endif
 }
 
 void DoorSet(int oi, int dx, int dy)
@@ -201,7 +201,7 @@ void DrawWarLord(int x, int y)
 	BYTE *sp, *setp;
 	int v;
 
-	setp = LoadFileInMem("Levels\\L4Data\\Warlord2.DUN", NULL);
+	setp = LoadLevelFileInMem("Levels\\L4Data\\Warlord2.DUN", NULL);
 	rw = *setp;
 	sp = setp + 2;
 	rh = *sp;
@@ -232,7 +232,7 @@ void DrawSChamber(int q, int x, int y)
 	BYTE *sp, *setp;
 	int v;
 
-	setp = LoadFileInMem("Levels\\L2Data\\Bonestr1.DUN", NULL);
+	setp = LoadLevelFileInMem("Levels\\L2Data\\Bonestr1.DUN", NULL);
 	rw = *setp;
 	sp = setp + 2;
 	rh = *sp;
@@ -265,7 +265,7 @@ void DrawLTBanner(int x, int y)
 	int i, j;
 	BYTE *sp, *setp;
 
-	setp = LoadFileInMem("Levels\\L1Data\\Banner1.DUN", NULL);
+	setp = LoadLevelFileInMem("Levels\\L1Data\\Banner1.DUN", NULL);
 	rw = *setp;
 	sp = setp + 2;
 	rh = *sp;
@@ -291,7 +291,7 @@ void DrawBlind(int x, int y)
 	int i, j;
 	BYTE *sp, *setp;
 
-	setp = LoadFileInMem("Levels\\L2Data\\Blind1.DUN", NULL);
+	setp = LoadLevelFileInMem("Levels\\L2Data\\Blind1.DUN", NULL);
 	rw = *setp;
 	sp = setp + 2;
 	rh = *sp;
@@ -317,7 +317,7 @@ void DrawBlood(int x, int y)
 	int i, j;
 	BYTE *sp, *setp;
 
-	setp = LoadFileInMem("Levels\\L2Data\\Blood2.DUN", NULL);
+	setp = LoadLevelFileInMem("Levels\\L2Data\\Blood2.DUN", NULL);
 	rw = *setp;
 	sp = setp + 2;
 	rh = *sp;
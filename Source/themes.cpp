@@ -467,6 +467,7 @@ void HoldThemeRooms()
 	int i, x, y;
 	char v;
 
+	dirtyGrids |= DIRTY_FLAGS;
 	if (currlevel != 16) {
 		if (leveltype == DTYPE_CATHEDRAL) {
 			for (i = 0; i < numthemes; i++) {
@@ -288,6 +288,7 @@ void Freeupstairs()
 {
 	int i, tx, ty, xx, yy;
 
+	dirtyGrids |= DIRTY_FLAGS;
 	for (i = 0; i < numtrigs; i++) {
 		tx = trigs[i]._tx;
 		ty = trigs[i]._ty;
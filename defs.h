@@ -76,6 +76,9 @@
 #define MAXTRIGGERS				5
 #endif
 #define MAXVISION				32
+// tiles DoVisionMask covers around the origin, the longest crawl and its neighbour probe
+#define VISION_MASK_RADIUS		16
+#define VISION_MASK_SIZE		(2 * VISION_MASK_RADIUS + 1)
 #define MDMAXX					40
 #define MDMAXY					40
 #define MAXCHARLEVEL			51
@@ -0,0 +1,47 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+
+#include "../Source/mapGen/results.h"
+
+static void showUsage(std::string_view programName)
+{
+	std::cerr << "Usage: " << programName << " results.bin\n";
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		showUsage(argv[0]);
+		return 1;
+	}
+
+	FILE *resultsFile = fopen(argv[1], "rb");
+	if (resultsFile == nullptr) {
+		std::cerr << "Unable to open " << argv[1] << "\n";
+		return 1;
+	}
+
+	ResultFileHeader header;
+	if (fread(&header, sizeof(header), 1, resultsFile) != 1 || memcmp(header.magic, ResultFileMagic, sizeof(ResultFileMagic)) != 0) {
+		std::cerr << argv[1] << " is not a results file.\n";
+		return 1;
+	}
+	if (header.version != ResultFileVersion || header.recordSize != sizeof(ResultRecord)) {
+		std::cerr << argv[1] << " was written by an incompatible version.\n";
+		return 1;
+	}
+
+	static ResultRecord records[4096];
+	size_t count;
+	while ((count = fread(records, sizeof(ResultRecord), std::size(records), resultsFile)) != 0) {
+		for (size_t i = 0; i < count; i++)
+			std::cout << FormatResult(records[i]) << "\n";
+	}
+
+	fclose(resultsFile);
+
+	return 0;
+}
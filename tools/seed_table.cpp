@@ -7,12 +7,24 @@
 #include <iostream>
 #include <limits>
 #include <optional>
+#include <string>
 #include <string_view>
+#include <vector>
 
 static void showUsage(std::string_view programName)
 {
 	std::cout << "Usage: " << programName << " <level> <dungeon seed>\n";
 	std::cout << "       " << programName << " <game seed>\n";
+	std::cout << "       " << programName << " --batch <level> < seeds.txt\n";
+	std::cout << "\n";
+	std::cout << "Batch mode reads one dungeon seed per line and writes one tab separated record per seed:\n";
+	std::cout << "  dungeon seed, game seed, quests, reachability[, negated state game seed, quests, reachability]\n";
+	std::cout << "The negated state columns are only present when the dungeon seed could have come from a negated state.\n";
+	std::cout << "Quests is a bit mask of the active quests: Q_BUTCHER 1, Q_PWATER 2, Q_SKELKING 4, Q_GARBUND 8,\n";
+	std::cout << "Q_LTBANNER 16, Q_BLOOD 32, Q_ROCK 64, Q_BLIND 128, Q_ZHAR 256, Q_MUSHROOM 512, Q_ANVIL 1024,\n";
+	std::cout << "Q_WARLORD 2048, Q_VEIL 4096.\n";
+	std::cout << "Reachability is 0 if the game seed can be reached by setting the system time, 1 if it requires an\n";
+	std::cout << "NT based Windows and an old BIOS or using the Mac version, and 2 if it requires a modern recompile.\n";
 }
 
 template <typename resultType, typename intermediateType>
@@ -34,12 +46,12 @@ std::optional<resultType> parseNumber(std::string_view numericString, intermedia
 		// else fall through
 		[[fallthrough]];
 	case std::errc::result_out_of_range:
-		std::cout << numericString << " is outside the expected range of " << minValue << " to " << maxValue << ".\n";
+		std::cerr << numericString << " is outside the expected range of " << minValue << " to " << maxValue << ".\n";
 		break;
 
 	case std::errc::invalid_argument:
 	default:
-		std::cout << numericString << " does not appear to be numeric.\n";
+		std::cerr << numericString << " does not appear to be numeric.\n";
 		break;
 	}
 
@@ -56,6 +68,9 @@ static std::optional<uint32_t> parseSeed(std::string_view numericString)
 	return parseNumber<uint32_t, int64_t>(numericString, std::numeric_limits<int32_t>::min(), std::numeric_limits<uint32_t>::max());
 }
 
+/** Number of seeds resolved at a time in batch mode */
+constexpr size_t BatchSize = 4096;
+
 constexpr uint32_t Multiplier        = 22695477; // 0x015A4E35;
 constexpr uint32_t Increment         = 1;
 constexpr uint32_t InverseMultiplier = 690295837; // computed using PowerMod[22695477,-1,2^32] in Wolfram Playground
@@ -199,16 +214,35 @@ struct GameState {
 	}
 };
 
+enum class Reachability : uint8_t {
+	SystemClock,
+	OldSystem,
+	Recompile,
+};
+
+static Reachability determineReachability(uint32_t gameSeed)
+{
+	if (315532800 <= gameSeed && gameSeed <= 2177452799U)
+		return Reachability::SystemClock;
+	if (gameSeed < 315532800)
+		return Reachability::OldSystem;
+	return Reachability::Recompile;
+}
+
 static void renderSeedTable(const GameState &state)
 {
 	time_t startingTime = std::chrono::system_clock::to_time_t(std::chrono::time_point<std::chrono::system_clock>(std::chrono::seconds(state.startingSeed)));
 	std::cout << "Game seed: " << state.startingSeed << " (" << std::put_time(std::gmtime(&startingTime), "%Y-%m-%d %H:%M:%S");
-	if (315532800 <= state.startingSeed && state.startingSeed <= 2177452799U) {
+	switch (determineReachability(state.startingSeed)) {
+	case Reachability::SystemClock:
 		std::cout << " can be reached by setting the system time)\n";
-	} else if (state.startingSeed < 315532800) {
+		break;
+	case Reachability::OldSystem:
 		std::cout << " requires an NT based Windows and an old BIOS or using the Mac version)\n";
-	} else {
+		break;
+	case Reachability::Recompile:
 		std::cout << " requires a modern recompile)\n";
+		break;
 	}
 
 	Quests activeQuests = determineActiveQuests(state.seedTable[15]);
@@ -258,6 +292,162 @@ static void renderSeedTable(const GameState &state)
 	}
 }
 
+
+/**
+ * The RNG stepped a number of times, expressed as a single affine map: state * multiplier + increment
+ */
+struct RngJump {
+	uint32_t multiplier = 1;
+	uint32_t increment  = 0;
+};
+
+static RngJump advanceJump(int steps)
+{
+	RngJump jump;
+	for (int i = 0; i < steps; ++i) {
+		jump.multiplier = jump.multiplier * Multiplier;
+		jump.increment  = jump.increment * Multiplier + Increment;
+	}
+	return jump;
+}
+
+static RngJump backtrackJump(int steps)
+{
+	RngJump jump;
+	for (int i = 0; i < steps; ++i) {
+		jump.multiplier = jump.multiplier * InverseMultiplier;
+		jump.increment  = (jump.increment - Increment) * InverseMultiplier;
+	}
+	return jump;
+}
+
+/** Jump from the state that produced the dungeon seed of one level to the one of another level */
+static RngJump levelJump(int fromLevel, int toLevel)
+{
+	return toLevel >= fromLevel ? advanceJump(toLevel - fromLevel) : backtrackJump(fromLevel - toLevel);
+}
+
+static uint16_t questMask(const Quests &quests)
+{
+	const bool active[] = {
+		quests.butcher,
+		quests.pwater,
+		quests.skelking,
+		quests.garbund,
+		quests.ltbanner,
+		quests.blood,
+		quests.rock,
+		quests.blind,
+		quests.zhar,
+		quests.mushroom,
+		quests.anvil,
+		quests.warlord,
+		quests.veil,
+	};
+
+	uint16_t mask = 0;
+	for (size_t i = 0; i < std::size(active); ++i) {
+		if (active[i])
+			mask |= 1 << i;
+	}
+	return mask;
+}
+
+struct SeedRecord {
+	uint32_t gameSeed;
+	uint16_t quests;
+	Reachability reachability;
+};
+
+/**
+ * Resolves a batch of RNG states at the given level, written as independent lanes so the
+ * compiler can vectorise the jumps. The seed table keeps the given dungeon seeds at that level,
+ * also when the states are their negations.
+ */
+static void resolveBatch(uint8_t level, const uint32_t *seeds, const uint32_t *states, SeedRecord *records, size_t count)
+{
+	// Backtracking past the dungeon seeds of the levels before it and the call that seeded the RNG
+	const RngJump toGameSeed = backtrackJump(level + 1);
+	const RngJump toQuestLevel = levelJump(level, 15);
+
+	uint32_t gameSeeds[BatchSize];
+	uint32_t questSeeds[BatchSize];
+	for (size_t i = 0; i < count; ++i) {
+		gameSeeds[i]  = states[i] * toGameSeed.multiplier + toGameSeed.increment;
+		questSeeds[i] = states[i] * toQuestLevel.multiplier + toQuestLevel.increment;
+	}
+	for (size_t i = 0; i < count; ++i) {
+		// The seed table holds the absolute value, except for the level the seed was given for
+		questSeeds[i] = level == 15 ? seeds[i] : std::abs(static_cast<int32_t>(questSeeds[i]));
+	}
+
+	for (size_t i = 0; i < count; ++i) {
+		records[i].gameSeed     = gameSeeds[i];
+		records[i].quests       = questMask(determineActiveQuests(questSeeds[i]));
+		records[i].reachability = determineReachability(gameSeeds[i]);
+	}
+}
+
+static void writeRecord(std::string &out, const SeedRecord &record)
+{
+	out += '\t';
+	out += std::to_string(record.gameSeed);
+	out += '\t';
+	out += std::to_string(record.quests);
+	out += '\t';
+	out += std::to_string(static_cast<int>(record.reachability));
+}
+
+static int runBatch(uint8_t level)
+{
+	std::ios::sync_with_stdio(false);
+
+	std::vector<uint32_t> seeds;
+	std::vector<uint32_t> negatedStates;
+	std::vector<SeedRecord> records(BatchSize);
+	std::vector<SeedRecord> negatedRecords(BatchSize);
+	std::string out;
+
+	bool done = false;
+	uint64_t line = 0;
+	while (!done) {
+		seeds.clear();
+		for (std::string input; seeds.size() < BatchSize;) {
+			if (!std::getline(std::cin, input)) {
+				done = true;
+				break;
+			}
+			line++;
+			std::optional<uint32_t> seed = parseSeed(input.substr(0, input.find_first_of(" \t")));
+			if (!seed) {
+				std::cerr << "Could not parse dungeon seed on line " << line << ".\n";
+				return 1;
+			}
+			seeds.push_back(*seed);
+		}
+
+		negatedStates.resize(seeds.size());
+		for (size_t i = 0; i < seeds.size(); ++i) {
+			negatedStates[i] = -static_cast<int32_t>(seeds[i]);
+		}
+
+		resolveBatch(level, seeds.data(), seeds.data(), records.data(), seeds.size());
+		resolveBatch(level, seeds.data(), negatedStates.data(), negatedRecords.data(), seeds.size());
+
+		out.clear();
+		for (size_t i = 0; i < seeds.size(); ++i) {
+			out += std::to_string(seeds[i]);
+			writeRecord(out, records[i]);
+			if (0 < seeds[i] && seeds[i] <= std::numeric_limits<int32_t>::max())
+				writeRecord(out, negatedRecords[i]);
+			out += '\n';
+		}
+		std::cout << out;
+	}
+
+	return 0;
+}
+
 int main(int argc, char *argv[])
 {
 	if (argc < 2) {
@@ -265,6 +455,20 @@ int main(int argc, char *argv[])
 		return 1;
 	}
 
+	using namespace std::literals;
+	if ("--batch"sv == argv[1]) {
+		if (argc < 3) {
+			showUsage(argv[0]);
+			return 1;
+		}
+		std::optional<uint8_t> level = parseLevel(argv[2]);
+		if (!level) {
+			std::cerr << "Could not parse dungeon level.\n";
+			return 1;
+		}
+		return runBatch(*level);
+	}
+
 	std::optional<uint8_t> level;
 	if (argc > 2) {
 		level = parseLevel(*++argv);
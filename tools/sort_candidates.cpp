@@ -1,20 +1,26 @@
+#include <algorithm>
 #include <array>
 #include <charconv>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
-#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <optional>
 #include <string_view>
+#include <utility>
+#include <queue>
 #include <vector>
-#include <map>
+
+#include "../Source/mapGen/seedList.h"
+
+/** Number of candidates sorted in memory at a time, larger inputs are sorted in runs that are merged from disk */
+constexpr size_t DefaultChunkSize = 16 * 1024 * 1024;
 
 static void showUsage(std::string_view programName)
 {
-	std::cerr << "Usage: " << programName << " <target_timestamp> <level> seeds.txt [--verbose]\n";
+	std::cerr << "Usage: " << programName << " <target_timestamp> <level> seeds.txt [--verbose] [--chunk <seeds>]\n";
 }
 
 template <typename resultType, typename intermediateType>
@@ -62,21 +68,40 @@ constexpr uint32_t Multiplier        = 22695477; // 0x015A4E35;
 constexpr uint32_t Increment         = 1;
 constexpr uint32_t InverseMultiplier = 690295837; // computed using PowerMod[22695477,-1,2^32] in Wolfram Playground
 
-static uint32_t advanceRng(uint32_t state)
-{
-	return state * Multiplier + Increment;
-}
+/**
+ * The RNG stepped k times, expressed as a single affine map: state * multiplier + increment
+ */
+struct RngJump {
+	uint32_t multiplier;
+	uint32_t increment;
+
+	uint32_t operator()(uint32_t state) const
+	{
+		return state * multiplier + increment;
+	}
+};
 
-static uint32_t backtrackRng(uint32_t state)
+static RngJump backtrackJump(int steps)
 {
-	return (state - Increment) * InverseMultiplier;
+	RngJump jump { 1, 0 };
+	for (int i = 0; i < steps; ++i) {
+		// One step back from jump(state) is (jump(state) - Increment) * InverseMultiplier
+		jump.multiplier = jump.multiplier * InverseMultiplier;
+		jump.increment  = (jump.increment - Increment) * InverseMultiplier;
+	}
+	return jump;
 }
 
-static int32_t absShiftMod(uint32_t state, int32_t limit)
+/**
+ * Applies the jump to a batch of states, written so the compiler can vectorise the loop.
+ */
+static void backtrackBatch(const uint32_t *states, uint32_t *out, size_t count, RngJump jump)
 {
-	int32_t seed = static_cast<int32_t>(state);
-	seed         = seed == std::numeric_limits<int32_t>::min() ? std::numeric_limits<int32_t>::min() : std::abs(seed);
-	return (seed >> 16) % limit;
+	const uint32_t multiplier = jump.multiplier;
+	const uint32_t increment  = jump.increment;
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = states[i] * multiplier + increment;
+	}
 }
 
 static uint32_t absDelta(uint32_t a, uint32_t b)
@@ -90,27 +115,119 @@ static auto formatDate(uint32_t timestamp)
 	return std::put_time(std::gmtime(&time), "%Y-%m-%d %H:%M:%S");
 }
 
-struct SeedMap {
-	uint32_t dungeonSeed;
-	uint32_t gameSeed;
-	std::optional<uint32_t> altGameSeed {};
+/** Candidates are sorted as (delta << 32 | dungeon seed), only the delta half is used as the sort key. */
+static uint32_t keyDelta(uint64_t key)
+{
+	return static_cast<uint32_t>(key >> 32);
+}
 
-	SeedMap() = delete;
+static uint32_t keySeed(uint64_t key)
+{
+	return static_cast<uint32_t>(key);
+}
 
-	SeedMap(uint32_t dungeonSeed, uint32_t gameSeed)
-	    : dungeonSeed(dungeonSeed)
-	    , gameSeed(gameSeed)
-	{
+/**
+ * Stable LSD radix sort on the delta half of the keys, candidates with the same delta keep their input order.
+ */
+static void radixSort(std::vector<uint64_t> &keys, std::vector<uint64_t> &scratch)
+{
+	constexpr int RadixBits = 16;
+	constexpr size_t Buckets = 1 << RadixBits;
+
+	scratch.resize(keys.size());
+	std::vector<size_t> offsets(Buckets);
+	for (int shift = 32; shift < 64; shift += RadixBits) {
+		std::fill(offsets.begin(), offsets.end(), 0);
+		for (uint64_t key : keys) {
+			offsets[(key >> shift) & (Buckets - 1)]++;
+		}
+		size_t offset = 0;
+		for (size_t &bucket : offsets) {
+			size_t bucketSize = bucket;
+			bucket            = offset;
+			offset += bucketSize;
+		}
+		for (uint64_t key : keys) {
+			scratch[offsets[(key >> shift) & (Buckets - 1)]++] = key;
+		}
+		keys.swap(scratch);
 	}
+}
+
+/**
+ * A sorted run spilled to a temporary file, read back in blocks while merging.
+ */
+struct SortedRun {
+	FILE *file = nullptr;
+	std::vector<uint64_t> buffer {};
+	size_t position = 0;
 
-	SeedMap(uint32_t dungeonSeed, uint32_t gameSeed, uint32_t altGameSeed)
-	    : dungeonSeed(dungeonSeed)
-	    , gameSeed(gameSeed)
-	    , altGameSeed(altGameSeed)
+	bool fill()
 	{
+		buffer.resize(buffer.capacity());
+		buffer.resize(fread(buffer.data(), sizeof(uint64_t), buffer.size(), file));
+		position = 0;
+		return !buffer.empty();
 	}
 };
 
+static FILE *spillRun(const std::vector<uint64_t> &keys)
+{
+	FILE *run = std::tmpfile();
+	if (run == nullptr) {
+		std::cerr << "Unable to create a temporary file.\n";
+		exit(1);
+	}
+	if (fwrite(keys.data(), sizeof(uint64_t), keys.size(), run) != keys.size()) {
+		std::cerr << "Unable to write to a temporary file.\n";
+		exit(1);
+	}
+	rewind(run);
+	return run;
+}
+
+/**
+ * Merges the runs in order of delta, ties are taken from the earliest run so the merge stays stable.
+ */
+template <typename Callback>
+static void mergeRuns(std::vector<FILE *> &runFiles, Callback &&callback)
+{
+	constexpr size_t RunBufferSize = 64 * 1024;
+
+	std::vector<SortedRun> runs;
+	for (FILE *file : runFiles) {
+		SortedRun run { file };
+		run.buffer.reserve(RunBufferSize);
+		if (run.fill())
+			runs.push_back(std::move(run));
+	}
+
+	auto later = [&runs](size_t lhs, size_t rhs) {
+		uint32_t lhsDelta = keyDelta(runs[lhs].buffer[runs[lhs].position]);
+		uint32_t rhsDelta = keyDelta(runs[rhs].buffer[runs[rhs].position]);
+		return lhsDelta != rhsDelta ? lhsDelta > rhsDelta : lhs > rhs;
+	};
+	std::priority_queue<size_t, std::vector<size_t>, decltype(later)> heads(later);
+	for (size_t i = 0; i < runs.size(); ++i) {
+		heads.push(i);
+	}
+
+	while (!heads.empty()) {
+		size_t next   = heads.top();
+		SortedRun &run = runs[next];
+		heads.pop();
+
+		callback(run.buffer[run.position++]);
+
+		if (run.position < run.buffer.size() || run.fill())
+			heads.push(next);
+	}
+
+	for (FILE *file : runFiles) {
+		fclose(file);
+	}
+}
+
 int main(int argc, char *argv[])
 {
 	if (argc < 4) {
@@ -133,63 +250,85 @@ int main(int argc, char *argv[])
 		std::cerr << "Town seeds are frequently rerolled, if you're analysing a save this won't give you a useful table for comparison.\n\n";
 	}
 
-	std::fstream seedsFile;
-	seedsFile.open(argv[3]);
-	if (!seedsFile.is_open()) {
+	using namespace std::literals;
+	bool verbose     = false;
+	size_t chunkSize = DefaultChunkSize;
+	for (int i = 4; i < argc; ++i) {
+		if ("--verbose"sv == argv[i]) {
+			verbose = true;
+		} else if ("--chunk"sv == argv[i] && i + 1 < argc) {
+			std::optional<uint32_t> chunk = parseNumber<uint32_t, int64_t>(argv[++i], 1, std::numeric_limits<uint32_t>::max());
+			if (!chunk) {
+				std::cerr << "Could not parse chunk size.\n";
+				return 1;
+			}
+			chunkSize = *chunk;
+		} else {
+			showUsage(argv[0]);
+			return 1;
+		}
+	}
+
+	SeedReader seedsFile;
+	if (!seedsFile.Open(argv[3])) {
 		std::cerr << "Unable to open " << argv[3] << "\n";
 		return 1;
 	}
 
-	std::map<uint32_t, std::vector<SeedMap>> seedsByDelta {};
+	// Backtracking past the dungeon seeds of the levels before it and the call that seeded the RNG
+	const RngJump toGameSeed = backtrackJump(*level + 1);
 
-	for (std::string line; std::getline(seedsFile, line);) {
-		std::optional<uint32_t> seed = parseSeed(line);
-		if (!seed) {
-			std::cerr << "Could not parse seed.\n";
-			return 1;
-		}
+	std::vector<uint32_t> seeds;
+	std::vector<uint32_t> gameSeeds;
+	std::vector<uint64_t> keys;
+	std::vector<uint64_t> scratch;
+	std::vector<FILE *> runs;
+
+	uint64_t remaining = seedsFile.Count();
+	while (remaining != 0) {
+		size_t count = std::min<uint64_t>(remaining, chunkSize);
+		remaining -= count;
 
-		uint32_t state = *seed;
-		for (int i = *level - 1; i >= 0; --i) {
-			state = backtrackRng(state);
+		seeds.resize(count);
+		for (uint32_t &seed : seeds) {
+			seed = seedsFile.Next();
 		}
-		uint32_t startingSeed = backtrackRng(state);
 
-		uint32_t delta = absDelta(*targetTimestamp, startingSeed);
+		gameSeeds.resize(count);
+		backtrackBatch(seeds.data(), gameSeeds.data(), count, toGameSeed);
 
-		if (*seed <= std::numeric_limits<int32_t>::max()) {
-			state = -static_cast<int32_t>(*seed);
-			for (int i = *level - 1; i >= 0; --i) {
-				state = backtrackRng(state);
-			}
-			uint32_t negStartingSeed = backtrackRng(state);
+		keys.resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			keys[i] = static_cast<uint64_t>(absDelta(*targetTimestamp, gameSeeds[i])) << 32 | seeds[i];
+		}
+		radixSort(keys, scratch);
+
+		if (remaining != 0 || !runs.empty())
+			runs.push_back(spillRun(keys));
+	}
 
-			uint32_t negDelta = absDelta(*targetTimestamp, startingSeed);
+	std::ios::sync_with_stdio(false);
 
-			if (negDelta < delta) {
-				seedsByDelta[negDelta].emplace_back(*seed, negStartingSeed, startingSeed);
-			} else {
-				seedsByDelta[delta].emplace_back(*seed, startingSeed, negStartingSeed);
+	auto printCandidate = [&](uint64_t key) {
+		uint32_t seed = keySeed(key);
+		std::cout << seed;
+		if (verbose) {
+			uint32_t gameSeed = toGameSeed(seed);
+			std::cout << "\t" << gameSeed << "\t" << formatDate(gameSeed);
+			if (seed <= std::numeric_limits<int32_t>::max()) {
+				uint32_t altGameSeed = toGameSeed(-static_cast<int32_t>(seed));
+				std::cout << "\t" << altGameSeed << "\t" << formatDate(altGameSeed);
 			}
-		} else {
-			seedsByDelta[delta].emplace_back(*seed, startingSeed);
 		}
-	}
+		std::cout << "\n";
+	};
 
-	using namespace std::literals;
-	bool verbose = (argc >= 4 && "--verbose"sv == argv[4]);
-
-	for (auto &[_, seeds] : seedsByDelta) {
-		for (auto &seed : seeds) {
-			std::cout << seed.dungeonSeed;
-			if (verbose) {
-				std::cout << "\t" << seed.gameSeed << "\t" << formatDate(seed.gameSeed);
-				if (seed.altGameSeed) {
-					std::cout << "\t" << *seed.altGameSeed << "\t" << formatDate(*seed.altGameSeed);
-				}
-			}
-			std::cout << "\n";
+	if (runs.empty()) {
+		for (uint64_t key : keys) {
+			printCandidate(key);
 		}
+	} else {
+		mergeRuns(runs, printCandidate);
 	}
 
 	return 0;